@@ -0,0 +1,196 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file arena.h
+ * @brief Declaration for a monotonic arena which is freed at once
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace micro1 {
+
+/**
+ * @brief Monotonic arena which bumps a pointer in blocks of memory
+ *
+ * Memory is never freed one by one but all at once with the arena, so an
+ * allocation costs a few instructions instead of a call to malloc. An arena
+ * is not thread-safe: each thread allocates from its own child().
+ */
+class Arena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;  //! size of a block
+
+    /**
+     * @brief Constructor for Arena
+     * @param[in] block_size size of each block
+     */
+    explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE) : m_head(nullptr), m_end(nullptr), m_block_size(block_size), m_size(0) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocate memory which lives as long as the arena
+     * @param[in] size bytes to allocate
+     * @param[in] alignment alignment of the memory (a power of 2)
+     * @return void* the allocated memory
+     */
+    void* allocate(size_t size, size_t alignment) {
+        auto head = (reinterpret_cast<uintptr_t>(m_head) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        if (m_head == nullptr || head + size > reinterpret_cast<uintptr_t>(m_end))
+            return allocateBlock(size, alignment);
+
+        m_head = reinterpret_cast<char*>(head + size);
+        m_size += size;
+        return reinterpret_cast<void*>(head);
+    }
+    /**
+     * @brief Make an arena which is freed with this arena
+     * @return Arena& the new arena
+     */
+    Arena& child();
+    /**
+     * @brief Free all memory of the arena and its children
+     *
+     * Objects which are allocated from them must be destroyed before.
+     */
+    void reset();
+    /**
+     * @brief Return bytes allocated from the arena (excluding its children)
+     * @return size_t allocated bytes
+     */
+    size_t size() const { return m_size; }
+    /**
+     * @brief Return number of blocks of the arena (excluding its children)
+     * @return size_t number of blocks
+     */
+    size_t blocks() const { return m_blocks.size(); }
+
+private:
+    void* allocateBlock(size_t size, size_t alignment);
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;   //! blocks of memory
+    std::vector<std::unique_ptr<Arena>> m_children;  //! arenas which are freed with this arena
+    char* m_head;                                    //! head of free memory of the current block
+    char* m_end;                                     //! end of the current block
+    size_t m_block_size;                             //! size of each block
+    size_t m_size;                                   //! bytes allocated
+};
+
+/**
+ * @brief Allocator which allocates from an Arena
+ *
+ * A default constructed allocator has no arena and allocates from the heap,
+ * so containers with it work as usual outside of an assembly. A moved
+ * container keeps the arena of its elements, but a copy is made on the heap
+ * and an assigned container keeps its own allocator, so no copy refers to
+ * an arena which it may outlive or share with another thread.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    /**
+     * @brief Constructor for ArenaAllocator which allocates from the heap
+     */
+    ArenaAllocator() noexcept : m_arena(nullptr) {}
+    /**
+     * @brief Constructor for ArenaAllocator
+     * @param[in] arena an arena to allocate from (nullptr: the heap)
+     */
+    explicit ArenaAllocator(Arena* arena) noexcept : m_arena(arena) {}
+    /**
+     * @brief Constructor for ArenaAllocator from an allocator of another type
+     * @param[in] allocator an allocator
+     */
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& allocator) noexcept : m_arena(allocator.arena()) {}
+    /**
+     * @brief Return the allocator of a copy of a container
+     * @return ArenaAllocator an allocator which allocates from the heap
+     */
+    ArenaAllocator select_on_container_copy_construction() const noexcept { return ArenaAllocator(); }
+    /**
+     * @brief Allocate memory for objects
+     * @param[in] n number of objects
+     * @return T* the allocated memory
+     */
+    T* allocate(size_t n) {
+        if (m_arena)
+            return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    /**
+     * @brief Free memory (only if it is from the heap)
+     * @param[in] p the memory
+     */
+    void deallocate(T* p, size_t) noexcept {
+        if (!m_arena)
+            ::operator delete(p);
+    }
+    /**
+     * @brief Getter for m_arena
+     * @return Arena* the arena (nullptr: the heap)
+     */
+    Arena* arena() const { return m_arena; }
+
+private:
+    Arena* m_arena;  //! arena to allocate from
+};
+
+/**
+ * @brief Operator '==' for ArenaAllocator
+ * @return true if memory from one can be freed by the other
+ */
+template <typename T, typename U>
+bool
+operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena() == b.arena();
+}
+
+/**
+ * @brief Operator '!=' for ArenaAllocator
+ * @return true if memory from one can't be freed by the other
+ */
+template <typename T, typename U>
+bool
+operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return !(a == b);
+}
+
+}  // namespace micro1
+
+#endif  // ARENA_H
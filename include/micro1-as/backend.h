@@ -28,33 +28,53 @@
 #ifndef BACKEND_H
 #define BACKEND_H
 
-#include "parser.h"
+#include "context.h"
+
+#include <ostream>
+#include <string>
 
 namespace micro1 {
 
 /**
  * @brief Write a listing file
- * @param[in] rows parsed tokens
+ * @param[in] context parsed and resolved rows of a source program
  * @param[in] filename listing file name
+ * @param[in] cross_reference If true, write lines which define and refer to each label after the labels
+ */
+void
+writeListingFile(const AssemblyContext& context, const std::string filename, const bool cross_reference = false);
+
+/**
+ * @brief Print diagnostics to standard error output
+ * @param[in] context parsed rows of a source program
  */
 void
-writeListingFile(const Rows rows, const std::string filename);
+printDiagnostics(const AssemblyContext& context);
 
 /**
- * @brief Print syntax errors to standard error output
- * @param[in] rows parsed tokens
+ * @brief Print syntax errors (diagnostics and undefined references) to standard error output
+ * @param[in] context parsed and resolved rows of a source program
  */
 void
-printSyntaxError(const Rows rows);
+printSyntaxError(const AssemblyContext& context);
 
 /**
  * @brief Write a object file
- * @param[in] rows parsed tokens
+ * @param[in] context parsed and resolved rows of a source program
  * @param[in] filename object file name
  * @return bool If true, lines are syntactically correct
  */
 bool
-writeObjectFile(const Rows rows, const std::string filename);
+writeObjectFile(const AssemblyContext& context, const std::string filename);
+
+/**
+ * @brief Write a object file to a stream
+ * @param[in] context parsed and resolved rows of a source program
+ * @param[in] os output stream (e.g. std::cout)
+ * @return bool If true, lines are syntactically correct
+ */
+bool
+writeObjectFile(const AssemblyContext& context, std::ostream& os);
 
 }  // namespace micro1
 
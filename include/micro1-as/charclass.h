@@ -0,0 +1,156 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file charclass.h
+ * @brief Locale-independent character classification for lexical analyzer
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+#include <cstdint>
+
+namespace micro1 {
+
+/**
+ * @brief Class of a character which starts a token
+ */
+enum class CharClass : uint8_t {
+    BLANK,      //! whitespaces except a new line
+    NEWLINE,    //! \n
+    SEMICOLON,  //! ; (start of comment)
+    DIGIT,      //! [0-9] (start of INTEGER)
+    ALPHA,      //! [A-Za-z] (start of STRING)
+    LPAREN,     //! (
+    RPAREN,     //! )
+    STAR,       //! *
+    SIGN,       //! +|-
+    COMMA,      //! ,
+    COLON,      //! :
+    QUOTE,      //! ' (start of CHARS)
+    DQUOTE,     //! "
+    OTHER       //! others (INVALID)
+};
+
+/**
+ * @brief Flags of a character which continues a token
+ */
+enum CharFlag : uint8_t {
+    CHAR_BLANK = 1 << 0,   //! whitespaces except a new line
+    CHAR_DIGIT = 1 << 1,   //! [0-9]
+    CHAR_XDIGIT = 1 << 2,  //! [A-Fa-f0-9] (continuation of INTEGER)
+    CHAR_ALNUM = 1 << 3,   //! [A-Za-z0-9] (continuation of STRING)
+    CHAR_OCTAL = 1 << 4,   //! [0-7]
+    CHAR_BINARY = 1 << 5   //! [01]
+};
+
+/**
+ * @brief Table of character classes and flags indexed by a byte
+ */
+struct CharTable {
+    CharClass cls[256];  //! class of a character which starts a token
+    uint8_t flags[256];  //! flags of a character which continues a token
+};
+
+/**
+ * @brief Build CharTable
+ * @return CharTable table of character classes
+ */
+constexpr CharTable
+makeCharTable() {
+    CharTable table{};
+
+    for (int c = 0; c < 256; c++) {
+        table.cls[c] = CharClass::OTHER;
+        table.flags[c] = 0;
+    }
+
+    const char blanks[] = " \t\v\f\r";
+    for (int i = 0; blanks[i] != '\0'; i++) {
+        table.cls[static_cast<int>(blanks[i])] = CharClass::BLANK;
+        table.flags[static_cast<int>(blanks[i])] = CHAR_BLANK;
+    }
+    table.cls[static_cast<int>('\n')] = CharClass::NEWLINE;
+    table.cls[static_cast<int>(';')] = CharClass::SEMICOLON;
+
+    for (int c = '0'; c <= '9'; c++) {
+        table.cls[c] = CharClass::DIGIT;
+        table.flags[c] = CHAR_DIGIT | CHAR_XDIGIT | CHAR_ALNUM;
+        if (c <= '7')
+            table.flags[c] |= CHAR_OCTAL;
+        if (c <= '1')
+            table.flags[c] |= CHAR_BINARY;
+    }
+    for (int c = 'A'; c <= 'Z'; c++) {
+        table.cls[c] = CharClass::ALPHA;
+        table.cls[c - 'A' + 'a'] = CharClass::ALPHA;
+        table.flags[c] = CHAR_ALNUM;
+        table.flags[c - 'A' + 'a'] = CHAR_ALNUM;
+        if (c <= 'F') {
+            table.flags[c] |= CHAR_XDIGIT;
+            table.flags[c - 'A' + 'a'] |= CHAR_XDIGIT;
+        }
+    }
+
+    table.cls[static_cast<int>('(')] = CharClass::LPAREN;
+    table.cls[static_cast<int>(')')] = CharClass::RPAREN;
+    table.cls[static_cast<int>('*')] = CharClass::STAR;
+    table.cls[static_cast<int>('+')] = CharClass::SIGN;
+    table.cls[static_cast<int>('-')] = CharClass::SIGN;
+    table.cls[static_cast<int>(',')] = CharClass::COMMA;
+    table.cls[static_cast<int>(':')] = CharClass::COLON;
+    table.cls[static_cast<int>('\'')] = CharClass::QUOTE;
+    table.cls[static_cast<int>('"')] = CharClass::DQUOTE;
+
+    return table;
+}
+
+/**
+ * @brief Table of character classes
+ */
+inline constexpr CharTable CHAR_TABLE = makeCharTable();
+
+/**
+ * @brief Return class of a character which starts a token
+ * @param[in] c a character
+ * @return CharClass class of the character
+ */
+constexpr CharClass
+charClass(char c) {
+    return CHAR_TABLE.cls[static_cast<unsigned char>(c)];
+}
+
+/**
+ * @brief Test flags of a character
+ * @param[in] c a character
+ * @param[in] flag flags to be tested
+ * @return bool If true, the character has one of the flags
+ */
+constexpr bool
+hasCharFlag(char c, uint8_t flag) {
+    return (CHAR_TABLE.flags[static_cast<unsigned char>(c)] & flag) != 0;
+}
+
+}  // namespace micro1
+
+#endif  // CHARCLASS_H
@@ -0,0 +1,133 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file context.h
+ * @brief Declaration for the state of assembling a source program
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "arena.h"
+#include "diagnostic.h"
+#include "parser.h"
+#include "source.h"
+#include "symbol.h"
+#include "thread_pool.h"
+
+#include <string_view>
+
+namespace micro1 {
+
+/**
+ * @brief Class for the state of assembling a source program
+ *
+ * A context owns the rows of a source program, the arena which they are
+ * allocated from, their diagnostics, the symbol table, and the cross
+ * references of the symbols. parse() and
+ * resolve() fill them once, and every backend reads them by reference, so
+ * the symbol table is built once for a source program.
+ */
+class AssemblyContext {
+public:
+    /**
+     * @brief Constructor for AssemblyContext
+     * @param[in] source source program, which must outlive the context
+     */
+    explicit AssemblyContext(const SourceBuffer& source) : m_source(source) {}
+
+    AssemblyContext(const AssemblyContext&) = delete;
+    AssemblyContext& operator=(const AssemblyContext&) = delete;
+
+    /**
+     * @brief Parse the source program
+     * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+     */
+    void parse(size_t error_limit = 0);
+    /**
+     * @brief Parse the source program in parallel
+     * @param[in] pool threads which parse chunks of the source program
+     * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+     */
+    void parse(ThreadPool& pool, size_t error_limit = 0);
+    /**
+     * @brief Build the symbol table and resolve references of the rows
+     *
+     * Duplicate labels are added to diagnostics().
+     */
+    void resolve();
+    /**
+     * @brief Build the symbol table and resolve references of the rows in parallel
+     *
+     * Duplicate labels are added to diagnostics().
+     *
+     * @param[in] pool threads which resolve chunks of the rows
+     */
+    void resolve(ThreadPool& pool);
+    /**
+     * @brief Getter for m_source
+     * @return const SourceBuffer& the source program
+     */
+    const SourceBuffer& source() const { return m_source; }
+    /**
+     * @brief Getter for m_rows
+     * @return const Rows& parsed rows
+     */
+    const Rows& rows() const { return m_rows; }
+    /**
+     * @brief Getter for m_diagnostics
+     * @return const Diagnostics& diagnostics of the erroneous rows
+     */
+    const Diagnostics& diagnostics() const { return m_diagnostics; }
+    /**
+     * @brief Getter for m_symbol_table
+     * @return const SymbolTable& labels and their addresses (empty until resolve())
+     */
+    const SymbolTable& symbolTable() const { return m_symbol_table; }
+    /**
+     * @brief Getter for m_cross_reference
+     * @return const CrossReference& rows which refer to each symbol of symbolTable() (empty until resolve())
+     */
+    const CrossReference& crossReference() const { return m_cross_reference; }
+    /**
+     * @brief Return rows which refer to a label
+     * @param[in] label label name
+     * @return CrossReference::Range indices of the rows in order (empty if the label isn't defined)
+     */
+    CrossReference::Range references(std::string_view label) const;
+
+private:
+    void clear();
+    void buildSymbolTable();
+
+    const SourceBuffer& m_source;      //! source program which the rows refer to
+    Arena m_arena;                     //! memory of the tokens of m_rows, which is freed after them
+    Rows m_rows;                       //! parsed rows
+    Diagnostics m_diagnostics;         //! diagnostics of m_rows in order of the rows
+    SymbolTable m_symbol_table;        //! labels of m_rows
+    CrossReference m_cross_reference;  //! rows which refer to each symbol of m_symbol_table
+};
+
+}  // namespace micro1
+
+#endif  // CONTEXT_H
@@ -0,0 +1,134 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file diagnostic.h
+ * @brief Declaration for diagnostics of erroneous rows
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef DIAGNOSTIC_H
+#define DIAGNOSTIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace micro1 {
+
+/**
+ * @brief Code of a diagnostic, whose message is in a static table
+ */
+enum class DiagnosticCode : uint8_t {
+    NONE,                       //! no diagnostic
+    REQUIRED_TITLE,             //! the first line is not TITLE
+    REQUIRED_TITLE_NAME,        //! TITLE without a name
+    TOO_MANY_TOKENS,            //! tokens after an instruction
+    REQUIRED_LABEL_OR_OPECODE,  //! a line starts with neither a label nor an opecode
+    REQUIRED_OPECODE,           //! a label without an opecode
+    UNKNOWN_OPECODE,            //! an opecode which is not a keyword
+    REQUIRED_RB,                //! a missing rb register
+    REQUIRED_COMMA,             //! a missing comma after rb
+    REQUIRED_UINT,              //! a missing unsigned integer
+    REQUIRED_EOL_OR_LPAREN,     //! tokens after an unsigned integer
+    REQUIRED_RA,                //! a missing ra register
+    REQUIRED_RPAREN,            //! a missing right parenthesis
+    REQUIRED_SINT,              //! a missing signed integer
+    REQUIRED_SINT_OR_LPAREN,    //! a missing signed integer or left parenthesis
+    REQUIRED_LPAREN,            //! a missing left parenthesis
+    REQUIRED_ADDRESS,           //! a missing address
+    UNKNOWN_DEVICE_NAME,        //! a device name except CR and LPT
+    UNKNOWN_DEVICE_NUMBER,      //! a device number except 0 and 1
+    REQUIRED_DEVICE,            //! a missing device
+    REQUIRED_CONSTANT,          //! a missing constant of DC
+    REQUIRED_DECIMAL,           //! a missing decimal of DS
+    REQUIRED_HEXADECIMAL,       //! a missing hexadecimal of ORG
+    INVALID_TOKEN,              //! tokens after END
+    OFFSET_OUT_OF_RANGE,        //! an offset of an address which is larger than 0xFFFF
+    DUPLICATE_LABEL,            //! a label which is defined again
+    PREVIOUS_LABEL              //! the first definition of a duplicate label (a note, not an error)
+};
+
+/**
+ * @brief Return the message of a diagnostic code
+ * @param[in] code a diagnostic code
+ * @return const char* the message (empty for NONE)
+ */
+const char*
+getMessage(DiagnosticCode code);
+
+/**
+ * @brief Return whether a diagnostic code is an error
+ *
+ * A note (e.g. PREVIOUS_LABEL) is printed, but its row isn't erroneous.
+ *
+ * @param[in] code a diagnostic code
+ * @return bool If true, the row of the diagnostic is erroneous
+ */
+constexpr bool
+isError(DiagnosticCode code) {
+    return code != DiagnosticCode::NONE && code != DiagnosticCode::PREVIOUS_LABEL;
+}
+
+/**
+ * @brief Diagnostic of an erroneous row
+ *
+ * Diagnostics are kept apart from rows and refer to them by their indices,
+ * so correct rows have no diagnostic at all.
+ */
+struct Diagnostic {
+    size_t row;           //! index of the row
+    uint32_t index;       //! index of the token with error in the instruction of the row (0 for the label)
+    DiagnosticCode code;  //! what is wrong
+
+    /**
+     * @brief Operator '==' for Diagnostic
+     * @return Result of comparing two diagnostics
+     */
+    bool operator==(const Diagnostic& d) const {
+        return row == d.row && index == d.index && code == d.code;
+    }
+    /**
+     * @brief Operator '!=' for Diagnostic
+     * @return Result of comparing two diagnostics
+     */
+    bool operator!=(const Diagnostic& d) const {
+        return !(*this == d);
+    }
+};
+
+/**
+ * @brief Vector for diagnostics in order of the rows
+ */
+using Diagnostics = std::vector<Diagnostic>;
+
+/**
+ * @brief Return whether diagnostics have an error
+ * @param[in] diagnostics diagnostics of rows
+ * @return bool If true, a diagnostic is an error rather than a note
+ */
+bool
+hasError(const Diagnostics& diagnostics);
+
+}  // namespace micro1
+
+#endif  // DIAGNOSTIC_H
@@ -0,0 +1,202 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file document.h
+ * @brief Declaration for a source program which is edited and parsed incrementally
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+
+#include "diagnostic.h"
+#include "interner.h"
+#include "micro1.h"
+#include "parser.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace micro1 {
+
+/**
+ * @brief Rows of consecutive lines of a document
+ *
+ * Tokens of the rows have row numbers from 1 at the first line, and the
+ * first relative_rows rows have addresses from 0 at base. Row::renumber()
+ * with line and Row::addr() with base place a row in the document.
+ */
+struct RowChunk {
+    const Rows& rows;      //! rows of the lines
+    size_t line;           //! index of the first line in the document
+    size_t first;          //! index of the first row in the document
+    M1Addr base;           //! address where the lines start
+    size_t relative_rows;  //! number of rows with addresses relative to base
+};
+
+/**
+ * @brief Class for a source program which is parsed again after each edit
+ *
+ * Each line is kept in its own buffer, so tokens of the lines which are not
+ * edited stay valid. An edit tokenizes and parses only the edited lines and
+ * the following lines until the parser comes back to the state which it was
+ * in before the edit. The rows and diagnostics() are the same as parse() of
+ * text().
+ *
+ * Lines are grouped into chunks, and rows of a chunk are kept with row
+ * numbers and addresses from the start of the chunk. So an edit places
+ * again only the rows of the chunks which have edited lines, and moves the
+ * other chunks by their offsets. The rows are read by chunk() without
+ * copying them, or by row() one by one.
+ */
+class Document {
+public:
+    /**
+     * @brief Constructor for Document
+     * @param[in] text a source program
+     */
+    explicit Document(std::string_view text = "");
+
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    /**
+     * @brief Replace lines with text
+     * @param[in] row row number of the first replaced line (1-origin)
+     * @param[in] count number of replaced lines (0: text is inserted before row)
+     * @param[in] text new lines (empty: the lines are removed)
+     */
+    void edit(uint64_t row, uint64_t count, std::string_view text);
+    /**
+     * @brief Return number of chunks
+     * @return size_t number of chunks
+     */
+    size_t numberOfChunks() const { return m_chunks.size(); }
+    /**
+     * @brief Return rows of a chunk
+     * @param[in] index index of the chunk (less than numberOfChunks())
+     * @return RowChunk the rows and their offsets in the document
+     */
+    RowChunk chunk(size_t index) const;
+    /**
+     * @brief Return a parsed row at its row number and address
+     * @param[in] index index of the row (less than numberOfRows())
+     * @return Row a copy of the row
+     */
+    Row row(size_t index) const;
+    /**
+     * @brief Return number of parsed rows
+     * @return size_t number of rows
+     */
+    size_t numberOfRows() const { return m_chunks.empty() ? 0 : m_chunks.back().first + m_chunks.back().rows.size(); }
+    /**
+     * @brief Return diagnostics of the erroneous rows
+     * @return const Diagnostics& diagnostics in order of the rows
+     */
+    const Diagnostics& diagnostics() const;
+    /**
+     * @brief Getter for m_interner
+     * @return const Interner& the interner of identifiers of the rows
+     */
+    const Interner& interner() const { return m_interner; }
+    /**
+     * @brief Getter for m_size
+     * @return size_t number of lines
+     */
+    size_t size() const { return m_size; }
+    /**
+     * @brief Return a line of the source program
+     * @param[in] row row number (1-origin)
+     * @return std::string_view the line without the new line, or empty if row is out of range
+     */
+    std::string_view line(uint64_t row) const;
+    /**
+     * @brief Return the whole source program
+     * @return std::string the lines which are joined by new lines
+     */
+    std::string text() const;
+
+private:
+    /**
+     * @brief A line and the rows which are parsed from it
+     *
+     * Until the chunk places them, the rows are kept in the line, with row
+     * numbers from 1 at the line and the first relative_rows rows with
+     * addresses from 0 at the line.
+     */
+    struct Line {
+        std::unique_ptr<std::string> text;        //! bytes of the line with the new line
+        LineState state = LineState::LOAD_LABEL;  //! state after the line
+        M1Addr addr = 0;                          //! address after the line (relative if absolute is false)
+        size_t relative_rows = 0;                 //! number of rows with relative addresses
+        bool absolute = false;                    //! If true, ORG or DS has set the address
+        size_t count = 0;                         //! number of rows
+        Rows rows;                                //! rows which are not placed in the chunk yet
+        Diagnostics diagnostics;                  //! diagnostics of the rows (indexed from the first row of the line)
+        bool placed = false;                      //! If true, the rows are in the chunk
+        size_t index = 0;                         //! index of the line in the chunk where the rows are placed
+        size_t first = 0;                         //! index of the first row in the chunk
+        M1Addr base = 0;                          //! address where the line starts (relative to the chunk if relative is true)
+        bool relative = true;                     //! If true, no line before it in the chunk has set the address
+    };
+
+    /**
+     * @brief Consecutive lines, their rows and offsets in the document
+     */
+    struct Chunk {
+        std::vector<Line> lines;   //! lines of the chunk
+        Rows rows;                 //! rows of the lines, placed from the start of the chunk
+        size_t relative_rows = 0;  //! number of rows with addresses relative to base
+        size_t errors = 0;         //! number of diagnostics of the lines
+        size_t line = 0;           //! index of the first line in the document
+        size_t first = 0;          //! index of the first row in the document
+        M1Addr base = 0;           //! address where the chunk starts
+        M1Addr addr = 0;           //! address after the chunk (relative if absolute is false)
+        bool absolute = false;     //! If true, a line of the chunk has set the address
+        bool dirty = true;         //! If true, the lines have to be placed again
+    };
+
+    size_t find(size_t index) const;
+    Line& touch(size_t index);
+    void splice(size_t first, size_t last, std::vector<Line>& lines);
+    void balance(size_t index);
+    void unplace(size_t index, size_t begin, size_t end);
+    void layout(Chunk& chunk);
+    void update();
+    void take(Line& line, ParsedLines& parsed, const Interner& interner);
+
+    std::vector<Chunk> m_chunks;            //! chunks of lines of the source program
+    size_t m_size;                          //! number of lines
+    size_t m_finished;                      //! index of the first FINISHED line, e.g. END (or size() if none)
+    std::unique_ptr<std::string> m_tail;    //! copy of the lines from m_finished, which are parsed at once
+    std::deque<std::string> m_identifiers;  //! identifiers which m_interner refers to
+    Interner m_interner;                    //! ids of identifiers of the rows
+    mutable Diagnostics m_diagnostics;      //! diagnostics of all rows which diagnostics() has collected
+    mutable bool m_reported;                //! If true, m_diagnostics is up to date
+};
+
+}  // namespace micro1
+
+#endif  // DOCUMENT_H
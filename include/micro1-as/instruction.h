@@ -28,7 +28,11 @@
 #ifndef INSTRUCTION_H
 #define INSTRUCTION_H
 
-#include <string>
+#include "interner.h"
+
+#include <cstdint>
+#include <string_view>
+#include <tuple>
 
 namespace micro1 {
 
@@ -93,13 +97,39 @@ public:
     uint8_t nd() const { return static_cast<uint8_t>(m_value & 0xF); }
 };
 
+/**
+ * @brief Group and encoding of a mnemonic
+ */
+struct InstInfo {
+    InstGroup group;  //! instruction group
+    uint8_t op;       //! opecode encoding
+    uint8_t ra;       //! ra encoding
+    uint8_t rb;       //! rb encoding
+};
+
+/**
+ * @brief Return group and encoding of mnemonic
+ * @param[in] id id of the interned mnemonic
+ * @return const InstInfo& group and encoding (group is INVALID if id is not a mnemonic)
+ */
+const InstInfo&
+getInstInfo(SymbolId id);
+
 /**
  * @brief Return group number of mnemonic
  * @param[in] op MICRO-1 mnemonic
  * @return InstGroup number of instruction group
  */
 InstGroup
-getNumberOfGroup(std::string op);
+getNumberOfGroup(std::string_view op);
+
+/**
+ * @brief Return group number of mnemonic
+ * @param[in] id id of the interned mnemonic
+ * @return InstGroup number of instruction group
+ */
+InstGroup
+getNumberOfGroup(SymbolId id);
 
 /**
  * @brief Return instruction encoding
@@ -107,7 +137,15 @@ getNumberOfGroup(std::string op);
  * @return std::tuple<uint8_t,uint8_t,uint8_t> encoding { op, ra, rb }
  */
 std::tuple<uint8_t, uint8_t, uint8_t>
-getEncoding(std::string op);
+getEncoding(std::string_view op);
+
+/**
+ * @brief Return instruction encoding
+ * @param[in] id id of the interned mnemonic
+ * @return std::tuple<uint8_t,uint8_t,uint8_t> encoding { op, ra, rb }
+ */
+std::tuple<uint8_t, uint8_t, uint8_t>
+getEncoding(SymbolId id);
 
 }  // namespace micro1
 
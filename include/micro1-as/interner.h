@@ -0,0 +1,181 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file interner.h
+ * @brief Declaration for interning identifiers
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace micro1 {
+
+/**
+ * @brief Dense id of an interned identifier
+ */
+using SymbolId = uint32_t;
+
+/**
+ * @brief SymbolId of a token which is not an identifier
+ */
+const SymbolId NO_SYMBOL = UINT32_MAX;
+
+/**
+ * @brief Identifiers which are interned in advance
+ *
+ * The value of a keyword is its SymbolId in every Interner.
+ */
+enum class Keyword : SymbolId {
+    // GROUP1
+    ADD,
+    SUB,
+    AND,
+    OR,
+    XOR,
+    MULT,
+    DIV,
+    CMP,
+    EX,
+    // GROUP2
+    LC,
+    PUSH,
+    POP,
+    // GROUP3
+    SL,
+    SA,
+    SC,
+    BIX,
+    // GROUP4
+    LEA,
+    LX,
+    STX,
+    // GROUP5
+    L,
+    ST,
+    LA,
+    // GROUP6
+    BDIS,
+    BP,
+    BZ,
+    BM,
+    BC,
+    BNP,
+    BNZ,
+    BNM,
+    BNC,
+    B,  //! also prefix of binary numbers
+    BI,
+    BSR,
+    // GROUP7
+    RIO,
+    WIO,
+    // GROUP8
+    RET,
+    NOP,
+    HLT,
+    // GROUP9
+    DC,
+    DS,
+    ORG,
+    // directives
+    TITLE,
+    END,
+    // devices
+    CR,
+    LPT,
+    // prefixes of numbers
+    X,
+    O,
+    NUMBER_OF_KEYWORDS
+};
+
+/**
+ * @brief Return SymbolId of a keyword
+ * @param[in] keyword a keyword
+ * @return SymbolId id of the keyword
+ */
+constexpr SymbolId
+toSymbolId(Keyword keyword) {
+    return static_cast<SymbolId>(keyword);
+}
+
+/**
+ * @brief Find a keyword
+ * @param[in] str an identifier
+ * @return SymbolId id of the keyword, or NO_SYMBOL if str is not a keyword
+ */
+SymbolId
+findKeyword(std::string_view str);
+
+/**
+ * @brief Class which maps identifiers to dense ids
+ *
+ * Identifiers are not copied, so the bytes which they refer to must
+ * outlive the interner. Keywords are found by findKeyword(), so only the
+ * other identifiers are in the map.
+ */
+class Interner {
+public:
+    /**
+     * @brief Constructor for Interner which interns all keywords
+     */
+    Interner();
+
+    /**
+     * @brief Intern an identifier
+     * @param[in] str an identifier
+     * @return SymbolId id of the identifier (a new id if it is the first time)
+     */
+    SymbolId intern(std::string_view str);
+    /**
+     * @brief Find an identifier
+     * @param[in] str an identifier
+     * @return SymbolId id of the identifier, or NO_SYMBOL if it isn't interned
+     */
+    SymbolId find(std::string_view str) const;
+    /**
+     * @brief Return an interned identifier
+     * @param[in] id id of the identifier
+     * @return std::string_view the identifier
+     */
+    std::string_view str(SymbolId id) const { return m_strings[id]; }
+    /**
+     * @brief Return number of interned identifiers
+     * @return size_t number of identifiers including keywords
+     */
+    size_t size() const { return m_strings.size(); }
+
+private:
+    std::unordered_map<std::string_view, SymbolId> m_ids;  //! id of each identifier except keywords
+    std::vector<std::string_view> m_strings;               //! identifier of each id
+};
+
+}  // namespace micro1
+
+#endif  // INTERNER_H
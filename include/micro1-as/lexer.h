@@ -28,19 +28,141 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include "source.h"
+#include "thread_pool.h"
 #include "token.h"
 
-#include <fstream>
+#include <istream>
+#include <string_view>
+#include <vector>
 
 namespace micro1 {
 
 /**
  * @brief tokenize a source program
- * @param[in] ifs a source program
- * @return Tokens lexical tokens
+ * @param[in] source a source program
+ * @return Tokens lexical tokens which refer to source
  */
-Tokens
-tokenize(std::ifstream& ifs);
+TokenStore
+tokenize(const SourceBuffer& source);
+
+/**
+ * @brief tokenize a source program in memory
+ * @param[in] data bytes of a source program
+ * @return Tokens lexical tokens which refer to data
+ */
+TokenStore
+tokenize(std::string_view data);
+
+/**
+ * @brief tokenize a source program in memory
+ * @param[in] bytes bytes of a source program
+ * @param[in] size number of bytes
+ * @return Tokens lexical tokens which refer to bytes
+ */
+TokenStore
+tokenize(const unsigned char* bytes, size_t size);
+
+/**
+ * @brief tokenize a source program read from a stream
+ * @param[in] is a source program
+ * @return Tokens lexical tokens which refer to a copy of the program held by themselves
+ */
+TokenStore
+tokenize(std::istream& is);
+
+/**
+ * @brief Lines of a source program which a thread processes
+ */
+struct SourceChunk {
+    std::string_view data;  //! lines of the chunk
+    uint64_t first_row;     //! row number of the first line
+};
+
+/**
+ * @brief Minimum bytes of a chunk, since a smaller chunk is not worth a thread
+ */
+const size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * @brief Split a source program into chunks at new lines
+ * @param[in] data bytes of a source program
+ * @param[in] pool threads which process the chunks
+ * @return std::vector<SourceChunk> chunks in order (only one if the program is small or the pool has no worker)
+ */
+std::vector<SourceChunk>
+splitSource(std::string_view data, ThreadPool& pool);
+
+/**
+ * @brief tokenize a source program in parallel
+ * @param[in] source a source program
+ * @param[in] pool threads which tokenize chunks of the source program
+ * @return Tokens lexical tokens which refer to source (same as tokenize(source))
+ */
+TokenStore
+tokenize(const SourceBuffer& source, ThreadPool& pool);
+
+/**
+ * @brief Cursor over lexical tokens
+ *
+ * TokenStream tokenizes a source program on demand, one line at a time,
+ * so the parser can start before the whole program is tokenized and the
+ * lexer keeps only the tokens of the current line. The interner of the
+ * stream is kept across lines, because ids of the parsed rows refer to it,
+ * so its memory grows with the number of distinct identifiers.
+ * Lookahead by peek() is bounded by the current line. It is enough for
+ * the parser, which looks at most MAX_LOOKAHEAD tokens ahead
+ * (e.g. SIGN, X, ", 1F of -X"1F).
+ */
+class TokenStream {
+public:
+    //! the parser never looks further than this from the current token
+    static constexpr size_t MAX_LOOKAHEAD = 3;
+
+    explicit TokenStream(const SourceBuffer& source);
+    explicit TokenStream(std::string_view data, uint64_t first_row = 1);
+    explicit TokenStream(const TokenStore& tokens);
+
+    TokenStream(const TokenStream&) = delete;
+    TokenStream& operator=(const TokenStream&) = delete;
+
+    /**
+     * @brief Peek a token ahead of the current one
+     * @param[in] n distance from the current token (0: the current token)
+     * @return TokenRef the token, or no token if it is beyond the current line
+     */
+    TokenRef peek(size_t n = 0) const {
+        return n < m_tail - m_head ? TokenRef(m_store, m_head + n) : TokenRef();
+    }
+
+    /**
+     * @brief Test whether all tokens are consumed
+     * @return bool If true, no token remains
+     */
+    bool eof() const {
+        return m_head == m_tail;
+    }
+
+    void next();
+
+    /**
+     * @brief Return the interner of identifiers of the tokens
+     * @return const Interner& the interner
+     */
+    const Interner& interner() const { return m_store->interner(); }
+
+private:
+    void fill();
+
+    const TokenStore* m_store;  //! tokens which are read
+    size_t m_head;              //! index of the current token
+    size_t m_tail;              //! end of the available tokens
+    const char* m_next;         //! the next line to be tokenized
+    const char* m_end;          //! end of the source program
+    uint64_t m_row;             //! row number of the current line
+    bool m_lazy;                //! If true, tokens are made from the source program
+    TokenStore m_line;          //! tokens of the current line
+};
 
 }  // namespace micro1
 
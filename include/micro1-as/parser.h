@@ -28,69 +28,19 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include "arena.h"
+#include "diagnostic.h"
+#include "instruction.h"
+#include "lexer.h"
 #include "micro1.h"
 #include "token.h"
 
 #include <iostream>
+#include <string_view>
+#include <utility>
 
 namespace micro1 {
 
-/**
- * @brief Importance of debug imformation
- */
-enum class DebugInfoImportance {
-    ERROR,
-    WARNING,
-    INFO
-};
-
-/**
- * @brief Class for debug information
- */
-class DebugInfo {
-public:
-    /**
-     * @brief Constructor for DebugInfo
-     * @param[in] importance importance of debug information
-     * @param[in] message an error message
-     * @param[in] index index pointing to the token with error
-     */
-    DebugInfo(DebugInfoImportance importance, std::string message, uint64_t index) : m_importance(importance), m_message(message), m_index(index) {}
-    /**
-     * @brief Getter for m_importance
-     */
-    DebugInfoImportance importance() const { return m_importance; }
-    /**
-     * @brief Getter for m_message
-     */
-    std::string message() const { return m_message; }
-    /**
-     * @brief Getter for m_index
-     */
-    uint64_t index() const { return m_index; }
-    /**
-     * @brief Operator '==' for DebugInfo
-     * @return Result of comparing two DebugInfo objects
-     */
-    bool operator==(DebugInfo d) const {
-        return m_importance == d.importance() &&
-               m_message == d.message() &&
-               m_index == d.index();
-    }
-    /**
-     * @brief Operator '!=' for DebugInfo
-     * @return Result of comparing two DebugInfo objects
-     */
-    bool operator!=(DebugInfo d) const {
-        return !(*this == d);
-    }
-
-private:
-    DebugInfoImportance m_importance;  //! importance of debug information
-    std::string m_message;             //! error message
-    uint64_t m_index;                  //! index pointing to the token with error
-};
-
 /**
  * @brief Class for reference address
  */
@@ -101,12 +51,12 @@ public:
      * @param[in] label label name of the referenced address
      * @param[in] offset of address
      */
-    ReferenceAddress(std::string label, int64_t offset, M1Addr val = 0) : m_label(label), m_offset(offset), m_val(val), m_resolved(false) {}
+    ReferenceAddress(std::string_view label, int64_t offset, M1Addr val = 0) : m_label(label), m_offset(offset), m_val(val), m_resolved(false) {}
     /**
      * @brief Getter for m_label
-     * @return std::string label name
+     * @return std::string_view label name
      */
-    std::string label() const { return m_label; }
+    std::string_view label() const { return m_label; }
     /**
      * @brief Getter for m_offset
      * @return int64_t offset of address
@@ -134,7 +84,7 @@ public:
      * @brief Operator '==' for ReferenceAddress
      * @return Result of comparing two ReferenceAddress objects
      */
-    bool operator==(ReferenceAddress a) const {
+    bool operator==(const ReferenceAddress& a) const {
         return m_label == a.label() &&
                m_val == a.val() &&
                m_resolved == a.resolved() &&
@@ -144,15 +94,32 @@ public:
      * @brief Operator '!=' for ReferenceAddress
      * @return Result of comparing two ReferenceAddress objects
      */
-    bool operator!=(ReferenceAddress a) const {
+    bool operator!=(const ReferenceAddress& a) const {
         return !(*this == a);
     }
 
 private:
-    std::string m_label;  // ! label name
-    int64_t m_offset;     // ! offset of address
-    M1Addr m_val;         // ! address
-    bool m_resolved;      // ! true if address is resolved
+    std::string_view m_label;  // ! label name (refers to the source program)
+    int64_t m_offset;          // ! offset of address
+    M1Addr m_val;              // ! address
+    bool m_resolved;           // ! true if address is resolved
+};
+
+/**
+ * @brief Operands of an instruction which are parsed into integers
+ *
+ * The parser fills them while it takes the tokens, so the backend encodes
+ * an instruction without parsing its tokens again. An address of GROUP5 and
+ * GROUP6 is in ReferenceAddress.
+ */
+struct Operands {
+    SymbolId opecode = NO_SYMBOL;          //! id of the opecode
+    InstGroup group = InstGroup::INVALID;  //! group of the opecode
+    uint8_t op = 0;                        //! op field
+    uint8_t ra = 0;                        //! ra field
+    uint8_t rb = 0;                        //! rb field
+    M1Word value = 0;                      //! nd, device number, or the word of DC, DS and ORG
+    SymbolId label = NO_SYMBOL;            //! label whose address is the word of DC
 };
 
 /**
@@ -165,67 +132,103 @@ public:
      * @param[in] label label name in a line
      * @param[in] address
      * @param[in] instruction tokens which make up a instruction
-     * @param[in] dinfo debug information
      * @param[in] raddr address referenced by the instruction
+     * @param[in] operands operands parsed from the instruction
      */
-    Row(std::string label, M1Addr addr, Tokens instruction, DebugInfo dinfo, ReferenceAddress raddr) : m_label(label), m_addr(addr), m_instruction(instruction), m_dinfo(dinfo), m_raddr(raddr) {}
+    Row(std::string_view label, M1Addr addr, Tokens instruction, ReferenceAddress raddr, Operands operands = Operands())
+        : m_label(label), m_addr(addr), m_instruction(std::move(instruction)), m_raddr(std::move(raddr)), m_operands(operands) {}
     /**
      * @brief Getter for m_label
-     * @return std::string label name in a line
+     * @return std::string_view label name in a line
      */
-    std::string label() const { return m_label; }
+    std::string_view label() const { return m_label; }
     /**
      * @brief Getter for m_addr
      * @return M1Addr address
      */
     M1Addr addr() const { return m_addr; }
     /**
-     * @brief Getter for m_instruction
-     * @return Tokens tokens which make up a instruction
+     * @brief Setter for m_addr
+     * @param[in] addr_ address
      */
-    Tokens instruction() const { return m_instruction; }
+    void addr(M1Addr addr_) { m_addr = addr_; }
     /**
-     * @brief Getter for m_dinfo
-     * @return DebugInfo debug information
+     * @brief Getter for m_instruction
+     * @return const Tokens& tokens which make up a instruction
      */
-    DebugInfo dinfo() const { return m_dinfo; }
+    const Tokens& instruction() const { return m_instruction; }
     /**
      * @brief Getter for m_raddr
-     * @return ReferencedAddress address referenced by the instruction
+     * @return const ReferenceAddress& address referenced by the instruction
      */
-    ReferenceAddress raddr() const { return m_raddr; }
+    const ReferenceAddress& raddr() const { return m_raddr; }
     /**
      * @brief Setter for m_raddr
-     * @return
+     * @param[in] raddr_ address referenced by the instruction
      */
-    void raddr(ReferenceAddress raddr_) {
+    void raddr(const ReferenceAddress& raddr_) {
         m_raddr = raddr_;
     }
+    /**
+     * @brief Resolve m_raddr in place
+     * @param[in] val_ resolved value of the referenced address
+     */
+    void resolve(M1Addr val_) { m_raddr.val(val_); }
+    /**
+     * @brief Getter for m_operands
+     * @return Operands operands parsed from the instruction
+     */
+    const Operands& operands() const { return m_operands; }
+    /**
+     * @brief Replace ids of identifiers with ids of another interner
+     * @param[in] ids new id indexed by an old id
+     */
+    void remap(const std::vector<SymbolId>& ids) {
+        for (auto& token : m_instruction) {
+            if (token.id() != NO_SYMBOL)
+                token.id(ids[token.id()]);
+        }
+        if (m_operands.opecode != NO_SYMBOL)
+            m_operands.opecode = ids[m_operands.opecode];
+        if (m_operands.label != NO_SYMBOL)
+            m_operands.label = ids[m_operands.label];
+    }
+    /**
+     * @brief Move row numbers of the tokens
+     * @param[in] delta number which is added to the row numbers (e.g. index of the line of the row)
+     */
+    void renumber(int64_t delta) {
+        for (auto& token : m_instruction) {
+            token.row(static_cast<uint64_t>(static_cast<int64_t>(token.row()) + delta));
+        }
+    }
     /**
      * @brief Operator '==' for Row
+     *
+     * Operands aren't compared because they are made from the instruction.
+     *
      * @return Result of comparing two rows
      */
-    bool operator==(Row r) const {
+    bool operator==(const Row& r) const {
         return m_label == r.label() &&
                m_addr == r.addr() &&
                m_instruction == r.instruction() &&
-               m_dinfo == r.dinfo() &&
                m_raddr == r.raddr();
     }
     /**
      * @brief Operator '!=' for Row
      * @return Result of comparing two rows
      */
-    bool operator!=(Row r) const {
+    bool operator!=(const Row& r) const {
         return !(*this == r);
     }
 
 private:
-    std::string m_label;       //! label name in a line
+    std::string_view m_label;  //! label name in a line (refers to the source program)
     M1Addr m_addr;             //! address
     Tokens m_instruction;      //! instruction tokens which make up a instruction
-    DebugInfo m_dinfo;         //! debug information
     ReferenceAddress m_raddr;  //! address referenced by the instruction
+    Operands m_operands;       //! operands parsed from the instruction
 };
 
 /**
@@ -233,13 +236,97 @@ private:
  */
 using Rows = std::vector<Row>;
 
+/**
+ * @brief State of the parser at the beginning of a line
+ */
+enum class LineState : uint8_t {
+    WAIT_TITLE,  //! TITLE has not appeared yet
+    LOAD_LABEL,  //! a line starts with a label or an opecode
+    FINISHED     //! a line doesn't end the instruction (e.g. END), so the rest of lines are taken by it
+};
+
+/**
+ * @brief Rows of lines which are parsed from address 0
+ *
+ * Addresses of the first relative_rows rows are relative to the address
+ * where the lines start. ORG or DS sets the address, so the rest of rows
+ * have absolute addresses.
+ */
+struct ParsedLines {
+    Rows rows;                                //! parsed rows
+    LineState state = LineState::LOAD_LABEL;  //! state after the lines
+    M1Addr addr = 0;                          //! address after the lines (relative if absolute is false)
+    size_t relative_rows = 0;                 //! number of rows with relative addresses
+    bool absolute = false;                    //! If true, ORG or DS has set the address
+    Diagnostics diagnostics;                  //! diagnostics of the erroneous rows
+    bool stopped = false;                     //! If true, the error limit has stopped parsing
+};
+
 /**
  * @brief Parse lexical tokens
  * @param[in] tokens tokens which parsed by lexical analyzer
+ * @param[out] diagnostics If not null, diagnostics of the erroneous rows are stored in it
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
  * @return std::vector<Row> parsed tokens
  */
 Rows
-parse(const Tokens tokens);
+parse(const TokenStore& tokens, Diagnostics* diagnostics = nullptr, Arena* arena = nullptr, size_t error_limit = 0);
+
+/**
+ * @brief Parse lexical tokens pulled from a stream
+ * @param[in] stream tokens which are tokenized on demand
+ * @param[out] diagnostics If not null, diagnostics of the erroneous rows are stored in it
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return std::vector<Row> parsed tokens
+ */
+Rows
+parse(TokenStream& stream, Diagnostics* diagnostics = nullptr, Arena* arena = nullptr, size_t error_limit = 0);
+
+/**
+ * @brief Parse lines of lexical tokens pulled from a stream
+ *
+ * Lines are parsed as a part of a program whose preceding lines leave the
+ * parser in state, so a program can be parsed by pieces (e.g. chunks of
+ * lines in parallel, or lines which are edited).
+ *
+ * @param[in] stream tokens which are tokenized on demand
+ * @param[in] state state at the first line (WAIT_TITLE or LOAD_LABEL)
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return ParsedLines parsed rows
+ */
+ParsedLines
+parseLines(TokenStream& stream, LineState state, Arena* arena = nullptr, size_t error_limit = 0);
+
+/**
+ * @brief Tokenize and parse a source program at once
+ *
+ * Lines are tokenized while they are parsed, so no token array of the whole
+ * program is made. parse(const TokenStore&) does the same for tokens which
+ * are tokenized in advance.
+ *
+ * @param[in] source a source program
+ * @param[out] diagnostics If not null, diagnostics of the erroneous rows are stored in it
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return std::vector<Row> parsed tokens
+ */
+Rows
+parse(const SourceBuffer& source, Diagnostics* diagnostics = nullptr, Arena* arena = nullptr, size_t error_limit = 0);
+
+/**
+ * @brief Tokenize and parse a source program in parallel
+ * @param[in] source a source program
+ * @param[in] pool threads which parse chunks of the source program
+ * @param[out] diagnostics If not null, diagnostics of the erroneous rows are stored in it
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return std::vector<Row> parsed tokens (same as parse(source))
+ */
+Rows
+parse(const SourceBuffer& source, ThreadPool& pool, Diagnostics* diagnostics = nullptr, Arena* arena = nullptr, size_t error_limit = 0);
 
 }  // namespace micro1
 
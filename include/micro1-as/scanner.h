@@ -0,0 +1,71 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file scanner.h
+ * @brief Declaration for scanning runs of characters in source program
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+namespace micro1 {
+
+/**
+ * @brief Skip blanks (whitespaces except a new line)
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @return const char* first character which is not blank, or tail
+ */
+const char*
+skipBlanks(const char* head, const char* tail);
+
+/**
+ * @brief Skip alphabets and digits ([A-Za-z0-9])
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @return const char* first character which is not alphabet or digit, or tail
+ */
+const char*
+skipAlnums(const char* head, const char* tail);
+
+/**
+ * @brief Skip hexadecimal digits ([A-Fa-f0-9])
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @return const char* first character which is not hexadecimal digit, or tail
+ */
+const char*
+skipXDigits(const char* head, const char* tail);
+
+/**
+ * @brief Find a new line
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @return const char* the new line, or tail
+ */
+const char*
+findEOL(const char* head, const char* tail);
+
+}  // namespace micro1
+
+#endif  // SCANNER_H
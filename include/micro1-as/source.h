@@ -0,0 +1,123 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file source.h
+ * @brief Declaration for buffer of source program
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace micro1 {
+
+/**
+ * @brief Class owning the whole bytes of a source program
+ *
+ * Tokens refer to the bytes of SourceBuffer, so it must outlive them.
+ */
+class SourceBuffer {
+public:
+    /**
+     * @brief Constructor for SourceBuffer
+     */
+    SourceBuffer() : m_mapped(nullptr), m_mapped_size(0) {}
+    /**
+     * @brief Constructor for SourceBuffer
+     * @param[in] is a source program
+     */
+    explicit SourceBuffer(std::istream& is);
+    /**
+     * @brief Constructor for SourceBuffer
+     * @param[in] data bytes of a source program
+     */
+    explicit SourceBuffer(std::string data) : m_data(std::move(data)), m_mapped(nullptr), m_mapped_size(0) {}
+    /**
+     * @brief Destructor for SourceBuffer
+     */
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    /**
+     * @brief Load a source program from a file
+     *
+     * A regular file is mapped into memory. Other files like pipes are read
+     * at once.
+     *
+     * @param[in] filename a file name of source program
+     * @return bool If true, the file is loaded successfully
+     */
+    bool open(const std::string& filename);
+    /**
+     * @brief Load a source program from a stream
+     * @param[in] is a source program (e.g. std::cin)
+     * @return bool If true, the stream is read successfully
+     */
+    bool read(std::istream& is);
+    /**
+     * @brief Return bytes of the source program
+     * @return std::string_view bytes of the source program
+     */
+    std::string_view data() const {
+        return m_mapped ? std::string_view(m_mapped, m_mapped_size) : std::string_view(m_data);
+    }
+    /**
+     * @brief Return size of the source program
+     * @return size_t number of bytes
+     */
+    size_t size() const { return data().size(); }
+    /**
+     * @brief Return a line of the source program
+     *
+     * Offsets of the lines are indexed at the first call, so only a listing
+     * or diagnostics pays for them.
+     *
+     * @param[in] row row number (1-origin)
+     * @return std::string_view the line without the new line, or empty if row is out of range
+     */
+    std::string_view line(uint64_t row) const;
+
+private:
+    /**
+     * @brief Release the mapped file
+     */
+    void unmap();
+
+    std::string m_data;    //! bytes of the source program which are read
+    const char* m_mapped;  //! bytes of the source program which are mapped
+    size_t m_mapped_size;  //! number of mapped bytes
+
+    mutable std::vector<size_t> m_line_starts;  //! offset of each line (built lazily)
+};
+
+}  // namespace micro1
+
+#endif  // SOURCE_H
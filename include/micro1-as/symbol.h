@@ -28,17 +28,199 @@
 #ifndef SYMBOL_H
 #define SYMBOL_H
 
+#include "diagnostic.h"
 #include "parser.h"
+#include "thread_pool.h"
 
-#include <map>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace micro1 {
 
-std::map<std::string, micro1::M1Addr>
-generateSymbolTable(Rows rows);
+/**
+ * @brief A label and its address
+ */
+struct Symbol {
+    std::string_view label;  //! label name (refers to the source program)
+    M1Addr addr;             //! address of the label
+    size_t row = 0;          //! index of the row which defines the label first
+    bool duplicate = false;  //! If true, the label is defined more than once
+
+    bool operator==(const Symbol& s) const { return label == s.label && addr == s.addr && row == s.row && duplicate == s.duplicate; }
+    bool operator!=(const Symbol& s) const { return !(*this == s); }
+};
+
+/**
+ * @brief Class for a flat hash table of labels
+ *
+ * Symbols are stored in a vector in order of insertion, and a power of two
+ * array of slots refers to them by open addressing with linear probing.
+ * Each slot keeps the hash of its label, so a probe compares labels only
+ * when their hashes are equal. Labels are not copied, so the bytes which
+ * they refer to must outlive the table.
+ */
+class SymbolTable {
+public:
+    /**
+     * @brief Insert a label unless it is already in the table
+     * @param[in] label label name
+     * @param[in] addr address of the label
+     * @param[in] row index of the row which defines the label
+     * @return std::pair<Symbol*, bool> the symbol of the label (valid until the next insert), and false if it is already in the table and kept
+     */
+    std::pair<Symbol*, bool> insert(std::string_view label, M1Addr addr, size_t row = 0);
+    /**
+     * @brief Find a label
+     * @param[in] label label name
+     * @return const Symbol* the symbol of the label, or nullptr if it isn't in the table
+     */
+    const Symbol* find(std::string_view label) const;
+    /**
+     * @brief Return a symbol in order of insertion
+     * @param[in] index index of the symbol
+     * @return const Symbol& the symbol
+     */
+    const Symbol& operator[](size_t index) const { return m_symbols[index]; }
+    /**
+     * @brief Return index of a symbol in the table
+     * @param[in] symbol a symbol which find() returns
+     * @return size_t index of the symbol in order of insertion
+     */
+    size_t index(const Symbol& symbol) const { return static_cast<size_t>(&symbol - m_symbols.data()); }
+    /**
+     * @brief Return indices of symbols in order of labels
+     * @return std::vector<size_t> indices of symbols which are sorted by their labels
+     */
+    std::vector<size_t> order() const;
+    /**
+     * @brief Return symbols in order of labels
+     * @return std::vector<Symbol> symbols which are sorted by their labels
+     */
+    std::vector<Symbol> sorted() const;
+    /**
+     * @brief Remove all symbols
+     */
+    void clear();
+    /**
+     * @brief Return number of symbols
+     * @return size_t number of symbols
+     */
+    size_t size() const { return m_symbols.size(); }
+    /**
+     * @brief Return whether the table has no symbol
+     * @return bool If true, the table is empty
+     */
+    bool empty() const { return m_symbols.empty(); }
+
+private:
+    /**
+     * @brief A slot of the hash table
+     */
+    struct Slot {
+        uint32_t hash;   //! hash of the label
+        uint32_t index;  //! index of the symbol + 1 (0: empty)
+    };
+
+    void grow();
+
+    std::vector<Symbol> m_symbols;  //! symbols in order of insertion
+    std::vector<Slot> m_slots;      //! slots whose number is 0 or a power of two
+};
+
+/**
+ * @brief Class for rows which refer to each symbol
+ *
+ * Rows are kept in compressed sparse row layout: indices of the referencing
+ * rows of all symbols are in one vector, grouped by symbols in order of the
+ * symbol table and sorted in each group, and an offset of each group points
+ * into it. references() of a symbol takes time in proportion to its
+ * references, not to the rows.
+ */
+class CrossReference {
+public:
+    /**
+     * @brief Contiguous indices of rows
+     */
+    struct Range {
+        const size_t* first;  //! the first index
+        const size_t* last;   //! the end of the indices
 
-Rows
-resolveSymbols(Rows rows);
+        const size_t* begin() const { return first; }
+        const size_t* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    /**
+     * @brief Build the index from references
+     * @param[in] symbols number of symbols
+     * @param[in] references pairs of the index of a symbol and the index of a row which refers to it, in order of rows
+     */
+    void assign(size_t symbols, const std::vector<std::pair<size_t, size_t>>& references);
+    /**
+     * @brief Return rows which refer to a symbol
+     * @param[in] symbol index of the symbol in the symbol table
+     * @return Range indices of the rows in order (empty if symbol is out of range)
+     */
+    Range references(size_t symbol) const;
+    /**
+     * @brief Remove all references
+     */
+    void clear();
+    /**
+     * @brief Return number of symbols
+     * @return size_t number of symbols
+     */
+    size_t size() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+
+private:
+    std::vector<size_t> m_offsets;  //! offset of the references of each symbol, and the number of all references
+    std::vector<size_t> m_rows;     //! indices of the referencing rows grouped by symbols
+};
+
+/**
+ * @brief Build the symbol table of rows
+ *
+ * The first definition of a label is kept. If diagnostics is given, each
+ * redefinition appends DUPLICATE_LABEL of its row, and the first one of a
+ * label also appends PREVIOUS_LABEL of the row of the first definition, so
+ * the diagnostics are in order of redefinitions rather than rows.
+ *
+ * @param[in] rows parsed rows
+ * @param[out] diagnostics diagnostics which duplicate labels are appended to (nullptr: not reported)
+ * @return SymbolTable labels of the rows and their addresses
+ */
+SymbolTable
+generateSymbolTable(const Rows& rows, Diagnostics* diagnostics = nullptr);
+
+/**
+ * @brief Resolve references of rows
+ *
+ * A reference to a label and a DC of a label are cross references of the
+ * label.
+ *
+ * @param[in,out] rows parsed rows whose references are resolved in place
+ * @param[in] symbol_table labels of the rows
+ * @param[out] cross_reference rows which refer to each symbol (nullptr: not built)
+ */
+void
+resolveSymbols(Rows& rows, const SymbolTable& symbol_table, CrossReference* cross_reference = nullptr);
+
+/**
+ * @brief Resolve references of rows in parallel
+ *
+ * The symbol table is only read, so chunks of rows are resolved in place
+ * independently. The rows and the cross references are the same as
+ * resolveSymbols(rows, symbol_table, cross_reference).
+ *
+ * @param[in,out] rows parsed rows whose references are resolved in place
+ * @param[in] symbol_table labels of the rows
+ * @param[in] pool threads which resolve chunks of the rows
+ * @param[out] cross_reference rows which refer to each symbol (nullptr: not built)
+ */
+void
+resolveSymbols(Rows& rows, const SymbolTable& symbol_table, ThreadPool& pool, CrossReference* cross_reference = nullptr);
 
 }  // namespace micro1
 
@@ -0,0 +1,96 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file thread_pool.h
+ * @brief Declaration for pool of worker threads
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace micro1 {
+
+/**
+ * @brief Pool of worker threads which run indexed tasks
+ *
+ * The threads are created once and reused by every run().
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructor for ThreadPool
+     * @param[in] threads number of threads including the caller (0: number of cores)
+     */
+    explicit ThreadPool(unsigned threads = 0);
+    /**
+     * @brief Destructor for ThreadPool
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Return number of threads including the caller
+     * @return unsigned number of threads
+     */
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+    /**
+     * @brief Run task(0), ..., task(count - 1) and wait for all of them
+     *
+     * The caller runs tasks too. Tasks must not throw exceptions, and
+     * must not call run() of the same pool.
+     *
+     * @param[in] count number of tasks
+     * @param[in] task a task which takes its index
+     */
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    void work();
+    bool runNext(std::unique_lock<std::mutex>& lock);
+
+    std::vector<std::thread> m_workers;        //! worker threads
+    std::mutex m_mutex;                        //! guard of the following members
+    std::condition_variable m_wake;            //! notified when tasks come
+    std::condition_variable m_done;            //! notified when all tasks are finished
+    const std::function<void(size_t)>* m_task; //! task of the current run
+    size_t m_count;                            //! number of tasks of the current run
+    size_t m_next;                             //! index of the next task
+    size_t m_finished;                         //! number of finished tasks
+    uint64_t m_generation;                     //! incremented on each run
+    bool m_stop;                               //! If true, workers exit
+};
+
+}  // namespace micro1
+
+#endif  // THREAD_POOL_H
@@ -28,7 +28,16 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
-#include <string>
+#include "arena.h"
+#include "interner.h"
+#include "source.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace micro1 {
@@ -59,45 +68,66 @@ public:
     /**
      * @brief Constructor for Token
      * @param[in] kind token kind
-     * @param[in] line line where the token exists
+     * @param[in] line line where the token exists (only the token string is kept)
      * @param[in] size size of string
      * @param[in] row row number
      * @param[in] column column number
+     * @param[in] id id of the interned identifier (only STRING)
      */
-    Token(TokenKind kind, std::string line, size_t size, uint64_t row, uint64_t column) : m_kind(kind), m_line(line), m_size(size), m_row(row), m_column(column) {}
+    Token(TokenKind kind, std::string_view line, size_t size, uint64_t row, uint64_t column, SymbolId id = NO_SYMBOL)
+        : m_kind(kind), m_str(line.substr(std::min<size_t>(column, line.size()), size)), m_row(static_cast<uint32_t>(row)),
+          m_column(static_cast<uint32_t>(column)), m_id(id) {}
 
     /**
      * @brief Getter for m_kind
      * @return token kind
      */
     TokenKind kind() const { return m_kind; }
-    /**
-     * @brief Getter for m_line
-     * @return line where the token exists
-     */
-    std::string line() const { return m_line; }
     /**
      * @brief Getter for m_row
      * @return row number
      */
     uint64_t row() const { return m_row; }
+    /**
+     * @brief Setter for m_row
+     * @param[in] row_ row number
+     */
+    void row(uint64_t row_) { m_row = static_cast<uint32_t>(row_); }
     /**
      * @brief Getter for m_column
      * @return column number
      */
     uint64_t column() const { return m_column; }
+    /**
+     * @brief Getter for m_id
+     * @return SymbolId id of the interned identifier, or NO_SYMBOL
+     */
+    SymbolId id() const { return m_id; }
+    /**
+     * @brief Setter for m_id
+     * @param[in] id_ id of the interned identifier, or NO_SYMBOL
+     */
+    void id(SymbolId id_) { m_id = id_; }
+    /**
+     * @brief Test whether the token is a keyword
+     * @param[in] keyword a keyword
+     * @return bool If true, the token is the keyword
+     */
+    bool is(Keyword keyword) const { return m_id == toSymbolId(keyword); }
     /**
      * @brief Return string corresponding to the token
-     * @return std::string a token string
+     * @return std::string_view a token string
      */
-    std::string str() const { return m_line.substr(m_column, m_size); }
+    std::string_view str() const { return m_str; }
     /**
      * @brief Operator '==' for Token
+     *
+     * m_id is not compared because it is decided by the string.
+     *
      * @return Result of comparing two tokens
      */
-    bool operator==(Token t) const {
+    bool operator==(const Token& t) const {
         return m_kind == t.kind() &&
-               m_line == t.line() &&
                m_row == t.row() &&
                m_column == t.column() &&
                str() == t.str();
@@ -106,22 +136,270 @@ public:
      * @brief Operator '!=' for Token
      * @return Result of comparing two tokens
      */
-    bool operator!=(Token t) const {
+    bool operator!=(const Token& t) const {
         return !(*this == t);
     }
 
 private:
-    TokenKind m_kind;    //! token kind
-    std::string m_line;  //! a line with token
-    size_t m_size;       //! size of string
-    uint64_t m_row;      //! row number
-    uint64_t m_column;   //! column number
+    TokenKind m_kind;        //! token kind
+    std::string_view m_str;  //! token string
+    uint32_t m_row;          //! row number
+    uint32_t m_column;       //! column number
+    SymbolId m_id;           //! id of the interned identifier
 };
 
 /**
  * @brief Vector for token
+ *
+ * Tokens of the rows of an assembly are allocated from its arena, and the
+ * others from the heap.
  */
-using Tokens = std::vector<Token>;
+using Tokens = std::vector<Token, ArenaAllocator<Token>>;
+
+class TokenRef;
+
+/**
+ * @brief Compact store of tokens in structure-of-arrays layout
+ *
+ * A token takes 15 bytes: a kind (8 bits), an offset from the base of the
+ * store (32 bits), a length (16 bits), an index of its line (32 bits) and
+ * an id of the interned identifier (32 bits).
+ * The parser mostly reads kinds and ids, which are dense arrays.
+ * Lines are kept as offsets, once per line. Their text isn't kept; the
+ * source program tells it when a diagnostic needs it.
+ */
+class TokenStore {
+public:
+    /**
+     * @brief Iterator over tokens
+     */
+    class const_iterator {
+    public:
+        const_iterator(const TokenStore* store, size_t index) : m_store(store), m_index(index) {}
+        TokenRef operator*() const;
+        const_iterator& operator++() {
+            m_index++;
+            return *this;
+        }
+        bool operator==(const const_iterator& it) const { return m_index == it.m_index; }
+        bool operator!=(const const_iterator& it) const { return m_index != it.m_index; }
+
+    private:
+        const TokenStore* m_store;  //! store of tokens
+        size_t m_index;             //! index of the token
+    };
+    using iterator = const_iterator;
+
+    /**
+     * @brief Constructor for TokenStore
+     */
+    TokenStore() : m_base(nullptr), m_first_row(1) {}
+
+    /**
+     * @brief Remove all tokens and lines (the memory and the interner are kept)
+     * @param[in] base head of the bytes which tokens refer to
+     * @param[in] first_row row number of the first line
+     */
+    void clear(const char* base, uint64_t first_row);
+    /**
+     * @brief Start a new line
+     * @param[in] line a line without the new line
+     */
+    void addLine(std::string_view line);
+    /**
+     * @brief Add a token on the last line
+     *
+     * A STRING token is interned.
+     *
+     * @param[in] kind token kind
+     * @param[in] column column number
+     * @param[in] size size of string
+     */
+    void add(TokenKind kind, uint64_t column, size_t size);
+    /**
+     * @brief Append tokens of the lines following this store
+     *
+     * Identifiers of the store are interned again in this store.
+     *
+     * @param[in] store tokens with the same base
+     */
+    void append(const TokenStore& store);
+    /**
+     * @brief Keep a source program alive while the store exists
+     * @param[in] source the source program which tokens refer to
+     */
+    void hold(std::shared_ptr<const SourceBuffer> source) { m_source = std::move(source); }
+
+    /**
+     * @brief Return number of tokens
+     * @return size_t number of tokens
+     */
+    size_t size() const { return m_kinds.size(); }
+    /**
+     * @brief Test whether the store has no token
+     * @return bool If true, no token is stored
+     */
+    bool empty() const { return m_kinds.empty(); }
+    /**
+     * @brief Return kinds of all tokens
+     * @return const std::vector<uint8_t>& TokenKind of each token
+     */
+    const std::vector<uint8_t>& kinds() const { return m_kinds; }
+    /**
+     * @brief Return kind of a token
+     * @param[in] index index of the token
+     * @return TokenKind token kind
+     */
+    TokenKind kind(size_t index) const { return static_cast<TokenKind>(m_kinds[index]); }
+    /**
+     * @brief Return id of a token
+     * @param[in] index index of the token
+     * @return SymbolId id of the interned identifier, or NO_SYMBOL
+     */
+    SymbolId id(size_t index) const { return m_ids[index]; }
+    /**
+     * @brief Return the interner of identifiers
+     * @return const Interner& the interner
+     */
+    const Interner& interner() const { return m_interner; }
+    /**
+     * @brief Return row number of a token
+     * @param[in] index index of the token
+     * @return uint64_t row number
+     */
+    uint64_t row(size_t index) const { return m_first_row + m_line_indices[index]; }
+    /**
+     * @brief Return column number of a token
+     * @param[in] index index of the token
+     * @return uint64_t column number
+     */
+    uint64_t column(size_t index) const { return m_offsets[index] - m_line_starts[m_line_indices[index]]; }
+    /**
+     * @brief Return string corresponding to a token
+     * @param[in] index index of the token
+     * @return std::string_view a token string
+     */
+    std::string_view str(size_t index) const { return std::string_view(m_base + m_offsets[index], length(index)); }
+    /**
+     * @brief Return a token
+     * @param[in] index index of the token
+     * @return Token the token
+     */
+    Token token(size_t index) const { return Token(kind(index), std::string_view(m_base + m_line_starts[m_line_indices[index]], column(index) + length(index)), length(index), row(index), column(index), id(index)); }
+
+    TokenRef operator[](size_t index) const;
+    TokenRef at(size_t index) const;
+    TokenRef back() const;
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    size_t length(size_t index) const { return m_lengths[index] != LONG_LENGTH ? m_lengths[index] : longLength(index); }
+    size_t longLength(size_t index) const;
+    uint32_t offset(const char* ptr) const;
+
+    //! m_lengths of a token which is too long; the length is in m_long_lengths
+    static constexpr uint16_t LONG_LENGTH = UINT16_MAX;
+
+    const char* m_base;                                        //! head of the bytes which tokens refer to
+    uint64_t m_first_row;                                      //! row number of the first line
+    std::vector<uint8_t> m_kinds;                              //! TokenKind of each token
+    std::vector<uint32_t> m_offsets;                           //! offset of each token from m_base
+    std::vector<uint16_t> m_lengths;                           //! size of string of each token
+    std::vector<uint32_t> m_line_indices;                      //! index of the line of each token
+    std::vector<uint32_t> m_line_starts;                       //! offset of each line
+    std::vector<SymbolId> m_ids;                               //! id of each token
+    std::vector<std::pair<uint32_t, uint32_t>> m_long_lengths; //! index and size of long tokens
+    Interner m_interner;                                       //! identifiers of the tokens
+    std::shared_ptr<const SourceBuffer> m_source;              //! source program held by the store
+};
+
+/**
+ * @brief Lightweight reference to a token in TokenStore
+ *
+ * It has the same getters as Token. A default constructed TokenRef refers
+ * to no token.
+ */
+class TokenRef {
+public:
+    /**
+     * @brief Constructor for TokenRef which refers to no token
+     */
+    TokenRef() : m_store(nullptr), m_index(0) {}
+    /**
+     * @brief Constructor for TokenRef
+     * @param[in] store store of tokens
+     * @param[in] index index of the token
+     */
+    TokenRef(const TokenStore* store, size_t index) : m_store(store), m_index(index) {}
+
+    /**
+     * @brief Test whether it refers to a token
+     */
+    explicit operator bool() const { return m_store != nullptr; }
+    /**
+     * @brief Getter for kind
+     * @return token kind
+     */
+    TokenKind kind() const { return m_store->kind(m_index); }
+    /**
+     * @brief Getter for row
+     * @return row number
+     */
+    uint64_t row() const { return m_store->row(m_index); }
+    /**
+     * @brief Getter for column
+     * @return column number
+     */
+    uint64_t column() const { return m_store->column(m_index); }
+    /**
+     * @brief Getter for id
+     * @return SymbolId id of the interned identifier, or NO_SYMBOL
+     */
+    SymbolId id() const { return m_store->id(m_index); }
+    /**
+     * @brief Test whether the token is a keyword
+     * @param[in] keyword a keyword
+     * @return bool If true, the token is the keyword
+     */
+    bool is(Keyword keyword) const { return id() == toSymbolId(keyword); }
+    /**
+     * @brief Return string corresponding to the token
+     * @return std::string_view a token string
+     */
+    std::string_view str() const { return m_store->str(m_index); }
+    /**
+     * @brief Return a copy of the token
+     * @return Token the token
+     */
+    Token token() const { return m_store->token(m_index); }
+
+private:
+    const TokenStore* m_store;  //! store of tokens
+    size_t m_index;             //! index of the token
+};
+
+inline TokenRef
+TokenStore::const_iterator::operator*() const {
+    return TokenRef(m_store, m_index);
+}
+
+inline TokenRef
+TokenStore::operator[](size_t index) const {
+    return TokenRef(this, index);
+}
+
+inline TokenRef
+TokenStore::back() const {
+    return TokenRef(this, size() - 1);
+}
+
+bool
+operator==(const TokenStore& a, const TokenStore& b);
+bool
+operator==(const TokenStore& a, const Tokens& b);
+bool
+operator==(const Tokens& a, const TokenStore& b);
 
 }  // namespace micro1
 
@@ -48,6 +48,32 @@ function test_micro1_as () {
     return 0
 }
 
+function test_cross_reference () {
+    doller1_dirname=$(dirname $1)
+    expected_dirname=$(dirname ${doller1_dirname})
+    input_filename=$(basename $1)
+
+    echo "====================================================================="
+    echo "input: $1 (--cross-reference)"
+    echo "expected: ${expected_dirname}/expect/${input_filename%.asm}.a"
+    echo "result: ${1%.asm}.a"
+
+    ./bin/micro1-as --cross-reference $1
+    if [ $? != 0 ]; then
+        echo "Assembling failed"
+        return 1
+    fi
+
+    diff ${expected_dirname}/expect/${input_filename%.asm}.a ${1%.asm}.a --ignore-space-change
+    if [ $? != 0 ]; then
+        echo "Test failed"
+        return 1
+    fi
+
+    echo "Ok"
+    return 0
+}
+
 echo "Starting system tests..."
 
 # Set input files
@@ -74,6 +100,13 @@ for f in $(ls test/systemtest/input/*.asm); do
     return_count=$(($return_count + $?))
 done
 
+# the listing file with the cross reference of labels
+for f in $(ls test/systemtest/expect/*.a); do
+    input=test/systemtest/input/$(basename ${f%.a}).asm
+    test_cross_reference $input
+    return_count=$(($return_count + $?))
+done
+
 cd ..
 echo "Finished system tests"
 return $return_count
@@ -0,0 +1,87 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file arena.cc
+ * @brief Implementation of a monotonic arena
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/arena.h"
+
+#include <algorithm>
+
+namespace micro1 {
+
+/**
+ * @brief Make an arena which is freed with this arena
+ * @return Arena& the new arena
+ */
+Arena&
+Arena::child() {
+    m_children.push_back(std::make_unique<Arena>(m_block_size));
+    return *m_children.back();
+}
+
+/**
+ * @brief Free all memory of the arena and its children
+ *
+ * Objects which are allocated from them must be destroyed before.
+ */
+void
+Arena::reset() {
+    m_blocks.clear();
+    m_children.clear();
+    m_head = nullptr;
+    m_end = nullptr;
+    m_size = 0;
+}
+
+/**
+ * @brief Allocate memory from a new block
+ *
+ * A large allocation gets a block of its own, and the current block is
+ * kept for the following small allocations.
+ *
+ * @param[in] size bytes to allocate
+ * @param[in] alignment alignment of the memory (a power of 2)
+ * @return void* the allocated memory
+ */
+void*
+Arena::allocateBlock(size_t size, size_t alignment) {
+    const size_t block_size = std::max(m_block_size, size + alignment);
+    auto block = std::unique_ptr<char[]>(new char[block_size]);
+    const auto head = (reinterpret_cast<uintptr_t>(block.get()) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+
+    if (m_head != nullptr && block_size > m_block_size) {
+        m_blocks.push_back(std::move(block));
+    } else {
+        m_head = reinterpret_cast<char*>(head + size);
+        m_end = block.get() + block_size;
+        m_blocks.push_back(std::move(block));
+    }
+    m_size += size;
+
+    return reinterpret_cast<void*>(head);
+}
+
+}  // namespace micro1
@@ -29,109 +29,55 @@
 
 #include "micro1-as/instruction.h"
 #include "micro1-as/micro1.h"
-#include "micro1-as/symbol.h"
 
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <map>
 #include <tuple>
 
 namespace {
 
-using TokenIterator = micro1::Tokens::iterator;
-
-uint16_t
-extractUInt(TokenIterator head) {
-    if ((*head).kind() == micro1::TokenKind::INTEGER)
-        return static_cast<uint16_t>(std::stoi((*head).str()));
-
-    int base = 0;
-    if ((*head).str() == "X")
-        base = 16;
-    if ((*head).str() == "B")
-        base = 2;
-    if ((*head).str() == "O")
-        base = 8;
-
-    return static_cast<uint16_t>(std::stoi((*(head + 2)).str(), nullptr, base) & 0xFFFF);
-}
-
-int16_t
-extractSInt(TokenIterator head) {
-    if ((*head).kind() == micro1::TokenKind::SIGN) {
-        if ((*head).str()[0] == '+')
-            return extractUInt(head + 1);
-        else
-            return static_cast<int16_t>(0x10000 - extractUInt(head + 1));
-    }
-
-    return extractUInt(head);
-}
-
 std::tuple<uint8_t, std::uint8_t, std::uint8_t, std::uint8_t>
-setRegister(micro1::Row row, std::map<std::string, micro1::M1Addr> symbol_table) {
-    auto [op, ra, rb] = micro1::getEncoding(row.instruction().at(0).str());
-    uint8_t nd = 0;
-
-    switch (micro1::getNumberOfGroup(row.instruction().at(0).str())) {
+setRegister(const micro1::Row& row, const micro1::SymbolTable& symbol_table) {
+    const auto& operands = row.operands();
+    uint8_t op = operands.op;
+    uint8_t ra = operands.ra;
+    uint8_t rb = operands.rb;
+    uint8_t nd = static_cast<uint8_t>(operands.value & 0xFF);
+
+    switch (operands.group) {
         case micro1::InstGroup::GROUP1:
-            if ((*(row.instruction().end() - 1)).kind() == micro1::TokenKind::RPAREN)
-                ra = std::stoi((*(row.instruction().end() - 2)).str()) & 0x3;
-            rb = std::stoi(row.instruction().at(1).str(), nullptr, 10) & 0x3;
-            if ((*(row.instruction().begin() + 3)).kind() != micro1::TokenKind::LPAREN)
-                nd = extractUInt(row.instruction().begin() + 3) & 0xFF;
-            break;
+            [[fallthrough]];
         case micro1::InstGroup::GROUP2:
-            rb = std::stoi(row.instruction().at(1).str(), nullptr, 10) & 0x3;
-            nd = extractUInt(row.instruction().begin() + 3) & 0xFF;
-            break;
+            [[fallthrough]];
         case micro1::InstGroup::GROUP3:
-            rb = std::stoi(row.instruction().at(1).str(), nullptr, 10) & 0x3;
-            nd = extractSInt(row.instruction().begin() + 3) & 0xFF;
-            break;
+            [[fallthrough]];
         case micro1::InstGroup::GROUP4:
-            ra = std::stoi((*(row.instruction().end() - 2)).str()) & 0x3;
-            rb = std::stoi(row.instruction().at(1).str(), nullptr, 10) & 0x3;
-            if (row.instruction().at(3).kind() != micro1::TokenKind::LPAREN)
-                nd = extractSInt(row.instruction().begin() + 3) & 0xFF;
+            [[fallthrough]];
+        case micro1::InstGroup::GROUP7:
+            [[fallthrough]];
+        case micro1::InstGroup::GROUP8:
             break;
         case micro1::InstGroup::GROUP5:
-            rb = std::stoi(row.instruction().at(1).str(), nullptr, 10) & 0x3;
-            nd = row.raddr().val();
-            break;
+            [[fallthrough]];
         case micro1::InstGroup::GROUP6:
             nd = row.raddr().val();
             break;
-        case micro1::InstGroup::GROUP7:
-            if (row.instruction().at(1).kind() == micro1::TokenKind::STRING) {
-                if (row.instruction().at(1).str() == "CR")
-                    nd = 0;
-                else if (row.instruction().at(1).str() == "LPT")
-                    nd = 1;
-            } else if (row.instruction().at(1).kind() == micro1::TokenKind::INTEGER) {
-                nd = static_cast<uint8_t>(std::stoi(row.instruction().at(1).str()));
-            }
-            break;
-        case micro1::InstGroup::GROUP8:
-            break;
         case micro1::InstGroup::GROUP9: {
-            micro1::M1Word word;
-
-            if (row.instruction().at(0).str() == "DC") {
-                if (row.instruction().size() > 2 || row.instruction().at(1).kind() == micro1::TokenKind::INTEGER) {
-                    word = extractSInt(row.instruction().begin() + 1);
-                } else if (row.instruction().at(1).kind() == micro1::TokenKind::CHARS) {
-                    word = static_cast<micro1::M1Word>(row.instruction().at(1).str()[1]) << 8;
-                    word += static_cast<micro1::M1Word>(row.instruction().at(1).str()[2]) & 0xFF;
-                } else /* if (row.instruction().at(1).kind() == micro1::TokenKind::STRING) */ {
-                    word = symbol_table.at(row.instruction().at(1).str());
+            micro1::M1Word word = operands.value;
+
+            // DC of an address label
+            if (operands.label != micro1::NO_SYMBOL) {
+                const auto symbol = symbol_table.find(row.instruction().at(1).str());
+                if (symbol == nullptr) {
+                    std::cerr << "FATAL ERROR: ";
+                    std::cerr << "FILE: " << __FILE__ << ", ";
+                    std::cerr << "LINE: " << __LINE__ << std::endl;
+                    std::cerr << "UNDEFINED LABEL: " << row.instruction().at(1).str() << std::endl;
+                    exit(2);
                 }
-            } else if (row.instruction().at(0).str() == "DS") {
-                word = static_cast<micro1::M1Word>(std::stoi(row.instruction().at(1).str()));
-            } else /* if (row.instruction().at(0).str() == "ORG") */ {
-                word = static_cast<micro1::M1Word>(std::stoi(row.instruction().at(1).str(), nullptr, 16));
+                word = symbol->addr;
             }
 
             op = word >> 12;
@@ -152,17 +98,28 @@ setRegister(micro1::Row row, std::map<std::string, micro1::M1Addr> symbol_table)
     return {op, ra, rb, nd};
 }
 
+/**
+ * @brief Return the line number of a row
+ * @param[in] row a row
+ * @return uint64_t line number of the row (0 if the row has no token)
+ */
+uint64_t
+getLineNumber(const micro1::Row& row) {
+    return row.instruction().empty() ? 0 : row.instruction().at(0).row();
+}
+
 }  // namespace
 
 namespace micro1 {
 
 /**
  * @brief Write a listing file
- * @param[in] rows parsed tokens
+ * @param[in] context parsed and resolved rows of a source program
  * @param[in] filename listing file name
+ * @param[in] cross_reference If true, write lines which define and refer to each label after the labels
  */
 void
-writeListingFile(const Rows rows, const std::string filename) {
+writeListingFile(const AssemblyContext& context, const std::string filename, const bool cross_reference) {
     std::ofstream ofs(filename);
 
     if (!ofs) {
@@ -172,14 +129,25 @@ writeListingFile(const Rows rows, const std::string filename) {
 
     int64_t index = 0;
     uint64_t num_of_errors = 0;
-    auto symbol_table = micro1::generateSymbolTable(rows);
+    const auto& rows = context.rows();
+    const auto& diagnostics = context.diagnostics();
+    const auto& source = context.source();
+    const auto& symbol_table = context.symbolTable();
+
+    auto diagnostic = diagnostics.begin();
+    for (size_t i = 0; i < rows.size(); i++) {
+        const auto& row = rows[i];
+
+        // diagnostics are in order of the rows, and notes don't make a row erroneous
+        bool error = false;
+        for (; diagnostic != diagnostics.end() && diagnostic->row == i; diagnostic++)
+            error = error || isError(diagnostic->code);
 
-    for (auto row : rows) {
         if (row.instruction().size() == 0)
             continue;
 
         // print 'F'atal error or nothing
-        if (row.dinfo().importance() == DebugInfoImportance::ERROR) {
+        if (error) {
             ofs << "F ";
             num_of_errors++;
         } else if (row.raddr().label() != "" && !row.raddr().resolved()) {
@@ -190,8 +158,8 @@ writeListingFile(const Rows rows, const std::string filename) {
         }
 
         // print address & word data
-        auto opecode = row.instruction().at(0).str();
-        if (opecode == "TITLE" || opecode == "ORG" || opecode == "END") {
+        const auto& opecode = row.instruction().at(0);
+        if (opecode.is(Keyword::TITLE) || opecode.is(Keyword::ORG) || opecode.is(Keyword::END)) {
             for (int i = 0; i < 13; i++)
                 ofs << ' ';
         } else {
@@ -200,18 +168,18 @@ writeListingFile(const Rows rows, const std::string filename) {
             ofs << ' ';
 
             // word data
-            if (row.dinfo().importance() != DebugInfoImportance::INFO) {
+            if (error) {
                 for (int i = 0; i < 8; i++) {
                     ofs << ' ';
                 }
             } else {
                 auto [op, ra, rb, nd] = ::setRegister(row, symbol_table);
-                if (row.instruction().at(0).str() == "DC") {
+                if (row.instruction().at(0).is(micro1::Keyword::DC)) {
                     ofs << std::hex << std::uppercase << static_cast<uint32_t>(op);
                     ofs << std::hex << std::uppercase << static_cast<uint32_t>((ra << 2) + rb);
                     ofs << std::hex << std::setw(2) << std::setfill('0') << std::uppercase << static_cast<uint32_t>(nd) << "    ";
-                } else if (row.instruction().at(0).str() == "DS") {
-                    ofs << "0000    " << row.instruction().at(0).line() << std::endl;
+                } else if (row.instruction().at(0).is(micro1::Keyword::DS)) {
+                    ofs << "0000    " << source.line(row.instruction().at(0).row()) << std::endl;
 
                     for (int i = 0; i < (op << 12) + (ra << 10) + (rb << 8) + nd - 1; i++) {
                         ofs << "  ";
@@ -233,7 +201,7 @@ writeListingFile(const Rows rows, const std::string filename) {
         }
 
         // print a line of original program
-        ofs << row.instruction().at(0).line() << std::endl;
+        ofs << source.line(row.instruction().at(0).row()) << std::endl;
     }
 
     // output number of errors
@@ -255,51 +223,86 @@ writeListingFile(const Rows rows, const std::string filename) {
 
     // output labels
     ofs << "LABEL(S)" << std::endl;
-    for (auto [key, value] : symbol_table) {
-        ofs << key << ": ";
-        ofs << std::hex << std::setw(4) << std::setfill('0') << value;
+    for (const auto& symbol : symbol_table.sorted()) {
+        ofs << symbol.label << ": ";
+        ofs << std::hex << std::setw(4) << std::setfill('0') << symbol.addr;
         ofs << "    ";
     }
+
+    // output cross references like "{label}: {line of definition} / {lines of references}"
+    if (cross_reference) {
+        ofs << std::endl
+            << std::endl
+            << "CROSS REFERENCE(S)" << std::endl;
+        for (const auto index : symbol_table.order()) {
+            const auto& symbol = symbol_table[index];
+            ofs << symbol.label << ": ";
+            ofs << std::dec << ::getLineNumber(rows[symbol.row]) << " /";
+            for (const auto row : context.crossReference().references(index))
+                ofs << ' ' << ::getLineNumber(rows[row]);
+            ofs << std::endl;
+        }
+    }
 }
 
 /**
- * @brief Print syntax errors to standard error output
- * @param[in] rows parsed tokens
+ * @brief Print diagnostics to standard error output
+ * @param[in] context parsed rows of a source program
  */
 void
-printSyntaxError(const Rows rows) {
-    for (auto row : rows) {
-        if (row.dinfo().importance() == DebugInfoImportance::ERROR) {
-            auto index = row.dinfo().index();
-            auto number_of_row = row.instruction().at(0).row();
-            auto number_of_column = row.instruction().at(index).column();
+printDiagnostics(const AssemblyContext& context) {
+    const auto& rows = context.rows();
+    const auto& source = context.source();
+
+    for (const auto& diagnostic : context.diagnostics()) {
+        const auto& row = rows.at(diagnostic.row);
+        const auto& token = row.instruction().at(diagnostic.index);
+        auto number_of_row = token.row();
+        auto line = source.line(number_of_row);
+        auto number_of_column = token.column();
+        auto width = token.str().size();
+
+        // a diagnostic of a label marks the label, which refers to the line
+        if ((diagnostic.code == DiagnosticCode::DUPLICATE_LABEL || diagnostic.code == DiagnosticCode::PREVIOUS_LABEL) &&
+            row.label().data() >= line.data() && row.label().data() < line.data() + line.size()) {
+            number_of_column = static_cast<uint64_t>(row.label().data() - line.data());
+            width = row.label().size();
+        }
 
-            // print "{row}:{column}: {message}"
-            std::cerr << number_of_row << ":";
-            std::cerr << number_of_column << ": ";
-            std::cerr << row.dinfo().message() << std::endl;
+        // print "{row}:{column}: {message}"
+        std::cerr << number_of_row << ":";
+        std::cerr << number_of_column << ": ";
+        std::cerr << getMessage(diagnostic.code) << std::endl;
 
-            // print the line
-            std::cerr << row.instruction().at(0).line() << std::endl;
+        // print the line
+        std::cerr << line << std::endl;
 
-            // print marks like "       ^^^^^"
-            for (size_t i = 0; i < number_of_column; i++) {
-                std::cerr << " ";
-            }
-            for (size_t i = 0; i < row.instruction().at(index).str().size(); i++) {
-                std::cerr << "^";
-            }
-            std::cerr << std::endl;
+        // print marks like "       ^^^^^"
+        for (size_t i = 0; i < number_of_column; i++) {
+            std::cerr << " ";
+        }
+        for (size_t i = 0; i < width; i++) {
+            std::cerr << "^";
         }
+        std::cerr << std::endl;
     }
+}
 
-    auto symbol_table = micro1::generateSymbolTable(rows);
+/**
+ * @brief Print syntax errors (diagnostics and undefined references) to standard error output
+ * @param[in] context parsed and resolved rows of a source program
+ */
+void
+printSyntaxError(const AssemblyContext& context) {
+    printDiagnostics(context);
 
-    for (auto row : rows) {
+    const auto& symbol_table = context.symbolTable();
+
+    for (const auto& row : context.rows()) {
         if (row.raddr().label() == "" || row.raddr().label() == "*")
             continue;
 
-        if (symbol_table.find(row.raddr().label()) == symbol_table.end()) {
+        if (symbol_table.find(row.raddr().label()) == nullptr) {
             auto number_of_row = row.instruction().at(0).row();
 
             // print "{row}:{message}"
@@ -311,13 +314,13 @@ printSyntaxError(const Rows rows) {
 
 /**
  * @brief Write a object file
- * @param[in] rows parsed tokens
+ * @param[in] context parsed and resolved rows of a source program
  * @param[in] filename object file name
  * @return bool If true, lines are syntactically correct
  */
 bool
-writeObjectFile(const Rows rows, const std::string filename) {
-    if (std::count_if(rows.begin(), rows.end(), [](auto row) { return row.dinfo().importance() == DebugInfoImportance::ERROR; }) != 0)
+writeObjectFile(const AssemblyContext& context, const std::string filename) {
+    if (hasError(context.diagnostics()))
         return false;
 
     std::ofstream ofs(filename);
@@ -326,15 +329,29 @@ writeObjectFile(const Rows rows, const std::string filename) {
         exit(2);
     }
 
+    return writeObjectFile(context, ofs);
+}
+
+/**
+ * @brief Write a object file to a stream
+ * @param[in] context parsed and resolved rows of a source program
+ * @param[in] ofs output stream (e.g. std::cout)
+ * @return bool If true, lines are syntactically correct
+ */
+bool
+writeObjectFile(const AssemblyContext& context, std::ostream& ofs) {
+    if (hasError(context.diagnostics()))
+        return false;
+
     int64_t index = 0;
-    auto symbol_table = micro1::generateSymbolTable(rows);
-    for (auto row : rows) {
+    const auto& symbol_table = context.symbolTable();
+    for (const auto& row : context.rows()) {
         if (row.instruction().size() == 0)
             continue;
 
-        if (auto opecode = row.instruction().at(0).str(); opecode == "TITLE") {
+        if (const auto& opecode = row.instruction().at(0); opecode.is(Keyword::TITLE)) {
             ofs << "MM " << row.instruction().at(1).str();
-        } else if (opecode != "ORG" && opecode != "END") {
+        } else if (!opecode.is(Keyword::ORG) && !opecode.is(Keyword::END)) {
             ofs << std::endl;
             ofs << std::hex << std::setw(4) << std::setfill('0') << std::uppercase << row.addr();
             ofs << "  ";
@@ -344,9 +361,9 @@ writeObjectFile(const Rows rows, const std::string filename) {
             word = (word << 2) + ra;
             word = (word << 2) + rb;
             word = (word << 8) + nd;
-            if (opecode == "DC") {
+            if (opecode.is(Keyword::DC)) {
                 ofs << std::hex << std::setw(4) << std::setfill('0') << std::uppercase << word;
-            } else if (opecode == "DS") {
+            } else if (opecode.is(Keyword::DS)) {
                 ofs << "0000";
 
                 for (int i = 1; i < word; i++) {
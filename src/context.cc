@@ -0,0 +1,122 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file context.cc
+ * @brief Implementation for the state of assembling a source program
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/context.h"
+
+#include <algorithm>
+
+namespace micro1 {
+
+/**
+ * @brief Parse the source program
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ */
+void
+AssemblyContext::parse(size_t error_limit) {
+    clear();
+    m_rows = micro1::parse(m_source, &m_diagnostics, &m_arena, error_limit);
+}
+
+/**
+ * @brief Parse the source program in parallel
+ * @param[in] pool threads which parse chunks of the source program
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ */
+void
+AssemblyContext::parse(ThreadPool& pool, size_t error_limit) {
+    clear();
+    m_rows = micro1::parse(m_source, pool, &m_diagnostics, &m_arena, error_limit);
+}
+
+/**
+ * @brief Build the symbol table and resolve references of the rows
+ */
+void
+AssemblyContext::resolve() {
+    buildSymbolTable();
+    resolveSymbols(m_rows, m_symbol_table, &m_cross_reference);
+}
+
+/**
+ * @brief Build the symbol table and resolve references of the rows in parallel
+ * @param[in] pool threads which resolve chunks of the rows
+ */
+void
+AssemblyContext::resolve(ThreadPool& pool) {
+    buildSymbolTable();
+    resolveSymbols(m_rows, m_symbol_table, pool, &m_cross_reference);
+}
+
+/**
+ * @brief Remove the rows and free their memory
+ *
+ * The rows are destroyed before the arena which their tokens are in.
+ */
+void
+AssemblyContext::clear() {
+    m_cross_reference.clear();
+    m_symbol_table.clear();
+    m_diagnostics.clear();
+    m_rows.clear();
+    m_rows.shrink_to_fit();
+    m_arena.reset();
+}
+
+/**
+ * @brief Build the symbol table of the rows
+ *
+ * Diagnostics of duplicate labels are merged into the diagnostics of the
+ * parser, so they stay in order of the rows.
+ */
+void
+AssemblyContext::buildSymbolTable() {
+    const auto parsed = static_cast<std::ptrdiff_t>(m_diagnostics.size());
+
+    m_symbol_table = generateSymbolTable(m_rows, &m_diagnostics);
+
+    if (m_diagnostics.size() > static_cast<size_t>(parsed)) {
+        auto by_row = [](const Diagnostic& a, const Diagnostic& b) { return a.row < b.row; };
+        std::stable_sort(m_diagnostics.begin() + parsed, m_diagnostics.end(), by_row);
+        std::inplace_merge(m_diagnostics.begin(), m_diagnostics.begin() + parsed, m_diagnostics.end(), by_row);
+    }
+}
+
+/**
+ * @brief Return rows which refer to a label
+ * @param[in] label label name
+ * @return CrossReference::Range indices of the rows in order (empty if the label isn't defined)
+ */
+CrossReference::Range
+AssemblyContext::references(std::string_view label) const {
+    const auto symbol = m_symbol_table.find(label);
+    if (symbol == nullptr)
+        return {nullptr, nullptr};
+
+    return m_cross_reference.references(m_symbol_table.index(*symbol));
+}
+
+}  // namespace micro1
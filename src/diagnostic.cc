@@ -0,0 +1,92 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file diagnostic.cc
+ * @brief Messages of diagnostics
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/diagnostic.h"
+
+#include <algorithm>
+
+namespace {
+
+const char* const MESSAGES[] = {
+    "",
+    "Required \"TITLE\".",
+    "Required title name.",
+    "Too many tokens.",
+    "Required label name or opecode.",
+    "Required opecode.",
+    "Unknown opecode.",
+    "Required integer for rb register.",
+    "Required comma.",
+    "Required unsigned integer.",
+    "Required an end of line or a left parenthesis.",
+    "Required integer for ra register.",
+    "Required a right parenthesis.",
+    "Required signed integer.",
+    "Required signed integer or a left parenthesis.",
+    "Required a left parenthesis.",
+    "Required address.",
+    "Unknown device name.",
+    "Unknown device number.",
+    "Required device name or number.",
+    "Required constant value.",
+    "Required decimal.",
+    "Required hexadecimal.",
+    "Invalid token.",
+    "Offset out of range.",
+    "Duplicate label.",
+    "Previous definition of the label."
+};
+
+static_assert(sizeof(MESSAGES) / sizeof(MESSAGES[0]) == static_cast<size_t>(micro1::DiagnosticCode::PREVIOUS_LABEL) + 1,
+              "MESSAGES must have a message for each DiagnosticCode");
+
+}  // namespace
+
+namespace micro1 {
+
+/**
+ * @brief Return the message of a diagnostic code
+ * @param[in] code a diagnostic code
+ * @return const char* the message (empty for NONE)
+ */
+const char*
+getMessage(DiagnosticCode code) {
+    return ::MESSAGES[static_cast<size_t>(code)];
+}
+
+/**
+ * @brief Return whether diagnostics have an error
+ * @param[in] diagnostics diagnostics of rows
+ * @return bool If true, a diagnostic is an error rather than a note
+ */
+bool
+hasError(const Diagnostics& diagnostics) {
+    return std::any_of(diagnostics.begin(), diagnostics.end(), [](const Diagnostic& d) { return isError(d.code); });
+}
+
+}  // namespace micro1
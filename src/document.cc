@@ -0,0 +1,512 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file document.cc
+ * @brief Implementation for a source program which is edited and parsed incrementally
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/document.h"
+
+#include "micro1-as/lexer.h"
+#include "micro1-as/scanner.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace {
+
+//! number of lines of a chunk which is split from a large one
+constexpr size_t CHUNK_LINES = 256;
+
+/**
+ * @brief Replace elements of a vector with new elements
+ *
+ * Elements are assigned in place as far as possible, so the following
+ * elements are moved only if the number of elements is changed.
+ *
+ * @param[in,out] vec a vector
+ * @param[in] begin index of the first replaced element
+ * @param[in] end index after the last replaced element
+ * @param[in] elements new elements
+ */
+template <typename T>
+void
+replace(std::vector<T>& vec, size_t begin, size_t end, std::vector<T>& elements) {
+    const size_t common = std::min(end - begin, elements.size());
+    const auto at = vec.begin() + static_cast<std::ptrdiff_t>(begin + common);
+
+    std::move(elements.begin(), elements.begin() + static_cast<std::ptrdiff_t>(common), vec.begin() + static_cast<std::ptrdiff_t>(begin));
+    if (elements.size() > common) {
+        vec.insert(at, std::make_move_iterator(elements.begin() + static_cast<std::ptrdiff_t>(common)), std::make_move_iterator(elements.end()));
+    } else {
+        vec.erase(at, vec.begin() + static_cast<std::ptrdiff_t>(end));
+    }
+}
+
+}  // namespace
+
+namespace micro1 {
+
+/**
+ * @brief Constructor for Document
+ * @param[in] text a source program
+ */
+Document::Document(std::string_view text) : m_size(0), m_finished(0), m_reported(false) {
+    edit(1, 0, text);
+}
+
+/**
+ * @brief Replace lines with text
+ *
+ * The lines from the first edited one are parsed one by one. Parsing stops
+ * at the first line after the edited ones which starts in the same state as
+ * before, because the rest of rows are the same. Only the chunks of the
+ * parsed lines place their rows again, and the other chunks are moved as a
+ * whole. If a line doesn't leave the parser at the beginning of the next
+ * line (e.g. END), the rest of lines are parsed at once.
+ *
+ * @param[in] row row number of the first replaced line (1-origin)
+ * @param[in] count number of replaced lines (0: text is inserted before row)
+ * @param[in] text new lines (empty: the lines are removed)
+ */
+void
+Document::edit(uint64_t row, uint64_t count, std::string_view text) {
+    const size_t first = static_cast<size_t>(std::min<uint64_t>(std::max<uint64_t>(row, 1) - 1, m_size));
+    const size_t last = first + static_cast<size_t>(std::min<uint64_t>(count, m_size - first));
+
+    // the lines from END are parsed again if one of them is edited
+    const size_t start = last > m_finished ? std::min(first, m_finished) : first;
+    // state in which the line after the edited ones started
+    auto old_state = last == 0 ? LineState::WAIT_TITLE : touch(last - 1).state;
+
+    std::vector<Line> lines;
+    for (const char *head = text.data(), *end = text.data() + text.size(); head < end;) {
+        const char* tail = findEOL(head, end);
+        // the new line is kept, so an empty line is tokenized as a line
+        lines.emplace_back();
+        lines.back().text = std::make_unique<std::string>(std::string(head, tail) + '\n');
+        head = tail + 1;
+    }
+
+    const auto delta = static_cast<int64_t>(lines.size()) - static_cast<int64_t>(last - first);
+    const size_t kept = first + lines.size();
+    splice(first, last, lines);
+    m_finished = last > m_finished ? m_size : static_cast<size_t>(static_cast<int64_t>(m_finished) + delta);
+
+    std::unique_ptr<std::string> tail;
+    auto state = start == 0 ? LineState::WAIT_TITLE : touch(start - 1).state;
+    size_t index = start;
+    for (; index < m_size; index++) {
+        auto& line = touch(index);
+        if (index >= kept) {
+            if (state == old_state)
+                break;
+            old_state = line.state;
+        }
+
+        TokenStream stream(*line.text);
+        auto parsed = parseLines(stream, state);
+
+        if (parsed.state == LineState::FINISHED) {
+            tail = std::make_unique<std::string>();
+            for (size_t i = index; i < m_size; i++) {
+                auto& finished = touch(i);
+                auto text_ = std::move(finished.text);
+                tail->append(*text_);
+                finished = Line();
+                finished.text = std::move(text_);
+                finished.state = LineState::FINISHED;
+            }
+
+            TokenStream rest(*tail);
+            parsed = parseLines(rest, state);
+            take(line, parsed, rest.interner());
+            line.state = LineState::FINISHED;
+            m_finished = index;
+            index = m_size;
+            break;
+        }
+
+        take(line, parsed, stream.interner());
+        state = parsed.state;
+    }
+
+    if (index == m_size && !tail)
+        m_finished = m_size;
+    if (tail || m_finished == m_size)
+        m_tail = std::move(tail);
+
+    update();
+    m_reported = false;
+}
+
+/**
+ * @brief Return rows of a chunk
+ * @param[in] index index of the chunk (less than numberOfChunks())
+ * @return RowChunk the rows and their offsets in the document
+ */
+RowChunk
+Document::chunk(size_t index) const {
+    const auto& chunk = m_chunks[index];
+    return {chunk.rows, chunk.line, chunk.first, chunk.base, chunk.relative_rows};
+}
+
+/**
+ * @brief Return a parsed row at its row number and address
+ * @param[in] index index of the row (less than numberOfRows())
+ * @return Row a copy of the row
+ */
+Row
+Document::row(size_t index) const {
+    // the last chunk which starts at or before the row has it, because the others before it are empty
+    const auto& chunk = *std::prev(std::upper_bound(m_chunks.begin(), m_chunks.end(), index, [](size_t i, const Chunk& c) { return i < c.first; }));
+    const size_t local = index - chunk.first;
+
+    Row ret = chunk.rows[local];
+    if (local < chunk.relative_rows)
+        ret.addr(static_cast<M1Addr>(ret.addr() + chunk.base));
+    ret.renumber(static_cast<int64_t>(chunk.line));
+
+    return ret;
+}
+
+/**
+ * @brief Return diagnostics of the erroneous rows
+ *
+ * Only the chunks which have diagnostics are visited.
+ *
+ * @return const Diagnostics& diagnostics in order of the rows
+ */
+const Diagnostics&
+Document::diagnostics() const {
+    if (m_reported)
+        return m_diagnostics;
+
+    m_diagnostics.clear();
+    for (const auto& chunk : m_chunks) {
+        if (chunk.errors == 0)
+            continue;
+        for (const auto& line : chunk.lines) {
+            for (auto diagnostic : line.diagnostics) {
+                diagnostic.row += chunk.first + line.first;
+                m_diagnostics.push_back(diagnostic);
+            }
+        }
+    }
+    m_reported = true;
+
+    return m_diagnostics;
+}
+
+/**
+ * @brief Return a line of the source program
+ * @param[in] row row number (1-origin)
+ * @return std::string_view the line without the new line, or empty if row is out of range
+ */
+std::string_view
+Document::line(uint64_t row) const {
+    if (row == 0 || row > m_size)
+        return std::string_view();
+
+    const auto& chunk = m_chunks[find(row - 1)];
+    const auto& text = *chunk.lines[row - 1 - chunk.line].text;
+    return std::string_view(text.data(), text.size() - 1);
+}
+
+/**
+ * @brief Return the whole source program
+ * @return std::string the lines which are joined by new lines
+ */
+std::string
+Document::text() const {
+    std::string ret;
+    for (const auto& chunk : m_chunks) {
+        for (const auto& line : chunk.lines) {
+            ret.append(*line.text);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find the chunk of a line
+ * @param[in] index index of the line (size() finds the last chunk)
+ * @return size_t index of the chunk
+ */
+size_t
+Document::find(size_t index) const {
+    const auto it = std::upper_bound(m_chunks.begin(), m_chunks.end(), index, [](size_t i, const Chunk& c) { return i < c.line; });
+    return it == m_chunks.begin() ? 0 : static_cast<size_t>(it - m_chunks.begin()) - 1;
+}
+
+/**
+ * @brief Return a line which may be changed
+ *
+ * The chunk of the line places its rows again by the next update().
+ *
+ * @param[in] index index of the line
+ * @return Line& the line
+ */
+Document::Line&
+Document::touch(size_t index) {
+    auto& chunk = m_chunks[find(index)];
+    chunk.dirty = true;
+    return chunk.lines[index - chunk.line];
+}
+
+/**
+ * @brief Replace lines with new lines
+ *
+ * The new lines are put in the chunk of the first replaced line, and the
+ * rest of replaced lines are removed from the following chunks. Rows of the
+ * removed lines are dropped when their chunks place their rows again. Then
+ * the chunks are split or merged, so that each of them has a bounded number
+ * of lines.
+ *
+ * @param[in] first index of the first replaced line
+ * @param[in] last index after the last replaced line
+ * @param[in] lines new lines
+ */
+void
+Document::splice(size_t first, size_t last, std::vector<Line>& lines) {
+    if (m_chunks.empty())
+        m_chunks.emplace_back();
+
+    const size_t index = find(first);
+    auto& chunk = m_chunks[index];
+    const size_t local = first - chunk.line;
+    const size_t removed = std::min(last - first, chunk.lines.size() - local);
+    ::replace(chunk.lines, local, local + removed, lines);
+    chunk.dirty = true;
+
+    size_t next = index + 1;
+    for (size_t rest = last - first - removed; rest > 0; next++) {
+        auto& following = m_chunks[next];
+        const size_t count = std::min(rest, following.lines.size());
+        following.lines.erase(following.lines.begin(), following.lines.begin() + static_cast<std::ptrdiff_t>(count));
+        following.dirty = true;
+        rest -= count;
+    }
+
+    for (size_t i = next; i > index; i--) {
+        balance(i - 1);
+    }
+    m_size = m_size + lines.size() - (last - first);
+
+    update();
+}
+
+/**
+ * @brief Split or merge a chunk
+ *
+ * An empty chunk is removed, a small chunk is merged with its neighbors,
+ * and a large chunk is split into chunks of CHUNK_LINES lines. So two
+ * adjacent chunks which have been edited have more than CHUNK_LINES lines.
+ * Rows of the lines which move to another chunk are taken back into them.
+ *
+ * @param[in] index index of the chunk
+ */
+void
+Document::balance(size_t index) {
+    const auto merge = [this](size_t i) {
+        auto& next = m_chunks[i + 1];
+        unplace(i + 1, 0, next.lines.size());
+        auto& lines = m_chunks[i].lines;
+        lines.insert(lines.end(), std::make_move_iterator(next.lines.begin()), std::make_move_iterator(next.lines.end()));
+        m_chunks[i].dirty = true;
+        m_chunks.erase(m_chunks.begin() + static_cast<std::ptrdiff_t>(i + 1));
+    };
+
+    if (m_chunks[index].lines.empty()) {
+        m_chunks.erase(m_chunks.begin() + static_cast<std::ptrdiff_t>(index));
+        return;
+    }
+    if (index + 1 < m_chunks.size() && m_chunks[index].lines.size() + m_chunks[index + 1].lines.size() <= CHUNK_LINES)
+        merge(index);
+    if (index > 0 && m_chunks[index - 1].lines.size() + m_chunks[index].lines.size() <= CHUNK_LINES)
+        merge(--index);
+
+    auto& lines = m_chunks[index].lines;
+    if (lines.size() <= 2 * CHUNK_LINES)
+        return;
+
+    unplace(index, CHUNK_LINES, lines.size());
+    std::vector<Chunk> chunks;
+    for (size_t i = CHUNK_LINES; i < lines.size(); i += CHUNK_LINES) {
+        const auto begin = lines.begin() + static_cast<std::ptrdiff_t>(i);
+        const auto end = lines.begin() + static_cast<std::ptrdiff_t>(std::min(i + CHUNK_LINES, lines.size()));
+        chunks.emplace_back();
+        chunks.back().lines.assign(std::make_move_iterator(begin), std::make_move_iterator(end));
+    }
+    lines.erase(lines.begin() + static_cast<std::ptrdiff_t>(CHUNK_LINES), lines.end());
+    m_chunks[index].dirty = true;
+    m_chunks.insert(m_chunks.begin() + static_cast<std::ptrdiff_t>(index + 1), std::make_move_iterator(chunks.begin()), std::make_move_iterator(chunks.end()));
+}
+
+/**
+ * @brief Take rows of lines back from their chunk
+ *
+ * The rows are moved into the lines with row numbers and addresses from
+ * the start of each line, so that the lines can move to another chunk.
+ *
+ * @param[in] index index of the chunk
+ * @param[in] begin index of the first line in the chunk
+ * @param[in] end index after the last line in the chunk
+ */
+void
+Document::unplace(size_t index, size_t begin, size_t end) {
+    auto& chunk = m_chunks[index];
+    for (size_t i = begin; i < end; i++) {
+        auto& line = chunk.lines[i];
+        if (!line.placed)
+            continue;
+
+        const auto from = chunk.rows.begin() + static_cast<std::ptrdiff_t>(line.first);
+        line.rows.assign(std::make_move_iterator(from), std::make_move_iterator(from + static_cast<std::ptrdiff_t>(line.count)));
+        for (size_t j = 0; j < line.count; j++) {
+            if (j < line.relative_rows)
+                line.rows[j].addr(static_cast<M1Addr>(line.rows[j].addr() - line.base));
+            line.rows[j].renumber(-static_cast<int64_t>(line.index));
+        }
+        line.placed = false;
+    }
+}
+
+/**
+ * @brief Place rows of the lines of a chunk
+ *
+ * Rows which have been placed are moved by the difference of the start of
+ * their line, and new rows are moved from their lines. The rows of a chunk
+ * are moved, not copied.
+ *
+ * @param[in,out] chunk a chunk whose lines are changed
+ */
+void
+Document::layout(Chunk& chunk) {
+    Rows rows;
+    rows.reserve(chunk.rows.size());
+    chunk.relative_rows = 0;
+    chunk.errors = 0;
+    chunk.addr = 0;
+    chunk.absolute = false;
+
+    for (size_t i = 0; i < chunk.lines.size(); i++) {
+        auto& line = chunk.lines[i];
+        const auto offset = static_cast<int64_t>(i) - static_cast<int64_t>(line.index);
+        const auto base = static_cast<M1Addr>(chunk.addr - line.base);
+        const size_t first = rows.size();
+
+        if (line.placed) {
+            const auto from = chunk.rows.begin() + static_cast<std::ptrdiff_t>(line.first);
+            rows.insert(rows.end(), std::make_move_iterator(from), std::make_move_iterator(from + static_cast<std::ptrdiff_t>(line.count)));
+        } else {
+            rows.insert(rows.end(), std::make_move_iterator(line.rows.begin()), std::make_move_iterator(line.rows.end()));
+            line.rows.clear();
+        }
+        // rows of a line which hasn't moved in the chunk are kept as they are
+        for (size_t j = 0; (!line.placed || offset != 0 || base != 0) && j < line.count; j++) {
+            auto& row = rows[first + j];
+            if (j < line.relative_rows)
+                row.addr(static_cast<M1Addr>(row.addr() + (line.placed ? base : chunk.addr)));
+            row.renumber(line.placed ? offset : static_cast<int64_t>(i));
+        }
+
+        line.placed = true;
+        line.index = i;
+        line.first = first;
+        line.base = chunk.addr;
+        line.relative = !chunk.absolute;
+        if (!chunk.absolute)
+            chunk.relative_rows += line.relative_rows;
+        chunk.errors += line.diagnostics.size();
+        chunk.addr = line.absolute ? line.addr : static_cast<M1Addr>(chunk.addr + line.addr);
+        chunk.absolute = chunk.absolute || line.absolute;
+    }
+
+    chunk.rows = std::move(rows);
+    chunk.dirty = false;
+}
+
+/**
+ * @brief Place rows of the changed chunks and move all chunks
+ *
+ * Each chunk starts where the previous one ends, which is O(1) per chunk.
+ */
+void
+Document::update() {
+    size_t line = 0;
+    size_t first = 0;
+    M1Addr base = 0;
+    for (auto& chunk : m_chunks) {
+        if (chunk.dirty)
+            layout(chunk);
+
+        chunk.line = line;
+        chunk.first = first;
+        chunk.base = base;
+        line += chunk.lines.size();
+        first += chunk.rows.size();
+        base = chunk.absolute ? chunk.addr : static_cast<M1Addr>(base + chunk.addr);
+    }
+}
+
+/**
+ * @brief Take rows which are parsed from a line
+ *
+ * Identifiers which are new to the document are copied, because the line
+ * which they refer to may be removed by a later edit.
+ *
+ * @param[out] line the line which the rows are parsed from
+ * @param[in] parsed rows which are parsed from the line
+ * @param[in] interner the interner which ids of the rows refer to
+ */
+void
+Document::take(Line& line, ParsedLines& parsed, const Interner& interner) {
+    // keywords have the same ids in every interner
+    std::vector<SymbolId> ids(interner.size());
+    std::iota(ids.begin(), ids.begin() + toSymbolId(Keyword::NUMBER_OF_KEYWORDS), 0);
+    for (SymbolId id = toSymbolId(Keyword::NUMBER_OF_KEYWORDS); id < interner.size(); id++) {
+        ids[id] = m_interner.find(interner.str(id));
+        if (ids[id] == NO_SYMBOL) {
+            m_identifiers.emplace_back(interner.str(id));
+            ids[id] = m_interner.intern(m_identifiers.back());
+        }
+    }
+
+    for (auto& row : parsed.rows) {
+        row.remap(ids);
+    }
+
+    line.state = parsed.state;
+    line.addr = parsed.addr;
+    line.relative_rows = parsed.relative_rows;
+    line.absolute = parsed.absolute;
+    line.count = parsed.rows.size();
+    line.rows = std::move(parsed.rows);
+    line.diagnostics = std::move(parsed.diagnostics);
+    line.placed = false;
+}
+
+}  // namespace micro1
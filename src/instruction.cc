@@ -27,84 +27,112 @@
 
 #include "micro1-as/instruction.h"
 
-#include <map>
-#include <stdexcept>
-#include <vector>
+#include "micro1-as/interner.h"
 
 namespace {
 
-std::map<micro1::InstGroup, std::vector<std::string> > group = {
-    {micro1::InstGroup::GROUP1, {"ADD", "SUB", "AND", "OR", "XOR", "MULT", "DIV", "CMP", "EX"}},
-    {micro1::InstGroup::GROUP2, {"LC", "PUSH", "POP"}},
-    {micro1::InstGroup::GROUP3, {"SL", "SA", "SC", "BIX"}},
-    {micro1::InstGroup::GROUP4, {"LEA", "LX", "STX"}},
-    {micro1::InstGroup::GROUP5, {"L", "ST", "LA"}},
-    {micro1::InstGroup::GROUP6, {"BDIS", "BP", "BZ", "BM", "BC", "BNP", "BNZ", "BNM", "BNC", "B", "BI", "BSR"}},
-    {micro1::InstGroup::GROUP7, {"RIO", "WIO"}},
-    {micro1::InstGroup::GROUP8, {"RET", "NOP", "HLT"}},
-    {micro1::InstGroup::GROUP9, {"DC", "DS", "ORG"}}};
-
-std::map<std::string, std::tuple<uint8_t, uint8_t, uint8_t> > encoding = {
-    {"ADD", {0, 0, 0}},
-    {"SUB", {1, 0, 0}},
-    {"AND", {2, 0, 0}},
-    {"OR", {3, 0, 0}},
-    {"XOR", {4, 0, 0}},
-    {"SL", {5, 0, 0}},
-    {"SA", {5, 1, 0}},
-    {"SC", {5, 2, 0}},
-    {"MULT", {6, 0, 0}},
-    {"DIV", {7, 0, 0}},
-    {"CMP", {8, 0, 0}},
-    {"L", {9, 0, 0}},
-    {"ST", {9, 1, 0}},
-    {"LA", {9, 2, 0}},
-    {"LC", {9, 3, 0}},
-    {"LEA", {0xA, 0, 0}},
-    {"LX", {0xB, 0, 0}},
-    {"STX", {0xC, 0, 0}},
-    {"PUSH", {0xD, 0, 0}},
-    {"POP", {0xD, 1, 0}},
-    {"BIX", {0xD, 2, 0}},
-    {"BDIS", {0xD, 3, 0}},
-    {"BP", {0xE, 0, 0}},
-    {"BZ", {0xE, 0, 1}},
-    {"BM", {0xE, 0, 2}},
-    {"BC", {0xE, 0, 3}},
-    {"BNP", {0xE, 1, 0}},
-    {"BNZ", {0xE, 1, 1}},
-    {"BNM", {0xE, 1, 2}},
-    {"BNC", {0xE, 1, 3}},
-    {"B", {0xE, 2, 0}},
-    {"BI", {0xE, 2, 1}},
-    {"BSR", {0xE, 2, 2}},
-    {"RET", {0xE, 2, 3}},
-    {"RIO", {0xE, 3, 0}},
-    {"WIO", {0xE, 3, 1}},
-    {"NOP", {0xE, 3, 2}},
-    {"HLT", {0xE, 3, 3}},
-    {"EX", {0xF, 0, 0}}};
+//! group and encoding of each keyword in the order of micro1::Keyword
+const micro1::InstInfo INSTRUCTIONS[] = {
+    // GROUP1: ADD, SUB, AND, OR, XOR, MULT, DIV, CMP, EX
+    {micro1::InstGroup::GROUP1, 0, 0, 0},
+    {micro1::InstGroup::GROUP1, 1, 0, 0},
+    {micro1::InstGroup::GROUP1, 2, 0, 0},
+    {micro1::InstGroup::GROUP1, 3, 0, 0},
+    {micro1::InstGroup::GROUP1, 4, 0, 0},
+    {micro1::InstGroup::GROUP1, 6, 0, 0},
+    {micro1::InstGroup::GROUP1, 7, 0, 0},
+    {micro1::InstGroup::GROUP1, 8, 0, 0},
+    {micro1::InstGroup::GROUP1, 0xF, 0, 0},
+    // GROUP2: LC, PUSH, POP
+    {micro1::InstGroup::GROUP2, 9, 3, 0},
+    {micro1::InstGroup::GROUP2, 0xD, 0, 0},
+    {micro1::InstGroup::GROUP2, 0xD, 1, 0},
+    // GROUP3: SL, SA, SC, BIX
+    {micro1::InstGroup::GROUP3, 5, 0, 0},
+    {micro1::InstGroup::GROUP3, 5, 1, 0},
+    {micro1::InstGroup::GROUP3, 5, 2, 0},
+    {micro1::InstGroup::GROUP3, 0xD, 2, 0},
+    // GROUP4: LEA, LX, STX
+    {micro1::InstGroup::GROUP4, 0xA, 0, 0},
+    {micro1::InstGroup::GROUP4, 0xB, 0, 0},
+    {micro1::InstGroup::GROUP4, 0xC, 0, 0},
+    // GROUP5: L, ST, LA
+    {micro1::InstGroup::GROUP5, 9, 0, 0},
+    {micro1::InstGroup::GROUP5, 9, 1, 0},
+    {micro1::InstGroup::GROUP5, 9, 2, 0},
+    // GROUP6: BDIS, BP, BZ, BM, BC, BNP, BNZ, BNM, BNC, B, BI, BSR
+    {micro1::InstGroup::GROUP6, 0xD, 3, 0},
+    {micro1::InstGroup::GROUP6, 0xE, 0, 0},
+    {micro1::InstGroup::GROUP6, 0xE, 0, 1},
+    {micro1::InstGroup::GROUP6, 0xE, 0, 2},
+    {micro1::InstGroup::GROUP6, 0xE, 0, 3},
+    {micro1::InstGroup::GROUP6, 0xE, 1, 0},
+    {micro1::InstGroup::GROUP6, 0xE, 1, 1},
+    {micro1::InstGroup::GROUP6, 0xE, 1, 2},
+    {micro1::InstGroup::GROUP6, 0xE, 1, 3},
+    {micro1::InstGroup::GROUP6, 0xE, 2, 0},
+    {micro1::InstGroup::GROUP6, 0xE, 2, 1},
+    {micro1::InstGroup::GROUP6, 0xE, 2, 2},
+    // GROUP7: RIO, WIO
+    {micro1::InstGroup::GROUP7, 0xE, 3, 0},
+    {micro1::InstGroup::GROUP7, 0xE, 3, 1},
+    // GROUP8: RET, NOP, HLT
+    {micro1::InstGroup::GROUP8, 0xE, 2, 3},
+    {micro1::InstGroup::GROUP8, 0xE, 3, 2},
+    {micro1::InstGroup::GROUP8, 0xE, 3, 3},
+    // GROUP9: DC, DS, ORG
+    {micro1::InstGroup::GROUP9, 0, 0, 0},
+    {micro1::InstGroup::GROUP9, 0, 0, 0},
+    {micro1::InstGroup::GROUP9, 0, 0, 0},
+    // not instructions: TITLE, END, CR, LPT, X, O
+    {micro1::InstGroup::INVALID, 0, 0, 0},
+    {micro1::InstGroup::INVALID, 0, 0, 0},
+    {micro1::InstGroup::INVALID, 0, 0, 0},
+    {micro1::InstGroup::INVALID, 0, 0, 0},
+    {micro1::InstGroup::INVALID, 0, 0, 0},
+    {micro1::InstGroup::INVALID, 0, 0, 0}};
+
+static_assert(sizeof(INSTRUCTIONS) / sizeof(INSTRUCTIONS[0]) == static_cast<size_t>(micro1::Keyword::NUMBER_OF_KEYWORDS),
+              "INSTRUCTIONS must have all keywords");
+
+//! group and encoding of an identifier which is not a keyword
+const micro1::InstInfo NOT_INSTRUCTION = {micro1::InstGroup::INVALID, 0, 0, 0};
 
 }  // namespace
 
 namespace micro1 {
 
+/**
+ * @brief Return group and encoding of mnemonic
+ * @param[in] id id of the interned mnemonic
+ * @return const InstInfo& group and encoding (group is INVALID if id is not a mnemonic)
+ */
+const InstInfo&
+getInstInfo(SymbolId id) {
+    if (id >= toSymbolId(Keyword::NUMBER_OF_KEYWORDS))
+        return NOT_INSTRUCTION;
+
+    return INSTRUCTIONS[id];
+}
+
 /**
  * @brief Return group number of mnemonic
  * @param[in] op MICRO-1 mnemonic
  * @return InstGroup number of instruction group
  */
 InstGroup
-getNumberOfGroup(std::string op) {
-    for (auto g : group) {
-        auto [n, insts] = g;
-        for (auto inst : insts) {
-            if (op == inst) {
-                return n;
-            }
-        }
-    }
-    return InstGroup::INVALID;
+getNumberOfGroup(std::string_view op) {
+    return getInstInfo(findKeyword(op)).group;
+}
+
+/**
+ * @brief Return group number of mnemonic
+ * @param[in] id id of the interned mnemonic
+ * @return InstGroup number of instruction group
+ */
+InstGroup
+getNumberOfGroup(SymbolId id) {
+    return getInstInfo(id).group;
 }
 
 /**
@@ -113,12 +141,19 @@ getNumberOfGroup(std::string op) {
  * @return std::tuple<uint8_t,uint8_t,uint8_t> encoding { op, ra, rb }
  */
 std::tuple<uint8_t, uint8_t, uint8_t>
-getEncoding(std::string op) {
-    try {
-        return encoding.at(op);
-    } catch (std::out_of_range) {
-        return {0, 0, 0};
-    }
+getEncoding(std::string_view op) {
+    return getEncoding(findKeyword(op));
+}
+
+/**
+ * @brief Return instruction encoding
+ * @param[in] id id of the interned mnemonic
+ * @return std::tuple<uint8_t,uint8_t,uint8_t> encoding { op, ra, rb }
+ */
+std::tuple<uint8_t, uint8_t, uint8_t>
+getEncoding(SymbolId id) {
+    const auto& inst = getInstInfo(id);
+    return {inst.op, inst.ra, inst.rb};
 }
 
 }  // namespace micro1
@@ -0,0 +1,185 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file interner.cc
+ * @brief Implementation for interning identifiers
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/interner.h"
+
+#include <iterator>
+
+namespace {
+
+//! names of keywords in the order of micro1::Keyword
+constexpr std::string_view KEYWORDS[] = {
+    "ADD", "SUB", "AND", "OR", "XOR", "MULT", "DIV", "CMP", "EX",
+    "LC", "PUSH", "POP",
+    "SL", "SA", "SC", "BIX",
+    "LEA", "LX", "STX",
+    "L", "ST", "LA",
+    "BDIS", "BP", "BZ", "BM", "BC", "BNP", "BNZ", "BNM", "BNC", "B", "BI", "BSR",
+    "RIO", "WIO",
+    "RET", "NOP", "HLT",
+    "DC", "DS", "ORG",
+    "TITLE", "END",
+    "CR", "LPT",
+    "X", "O"};
+
+static_assert(sizeof(KEYWORDS) / sizeof(KEYWORDS[0]) == static_cast<size_t>(micro1::Keyword::NUMBER_OF_KEYWORDS),
+              "KEYWORDS must have all keywords");
+
+//! the longest keyword (TITLE)
+constexpr size_t MAX_KEYWORD_LENGTH = 5;
+
+//! number of slots of KEYWORD_TABLE
+constexpr size_t KEYWORD_TABLE_SIZE = 128;
+
+//! empty slot of KEYWORD_TABLE
+constexpr uint8_t NO_KEYWORD = UINT8_MAX;
+
+/**
+ * @brief Hash an identifier into a slot of KEYWORD_TABLE
+ *
+ * The coefficients are chosen so that no keywords share a slot.
+ *
+ * @param[in] str an identifier which is not empty
+ * @return size_t index of the slot
+ */
+constexpr size_t
+hashKeyword(std::string_view str) {
+    const size_t second = str.size() > 1 ? static_cast<unsigned char>(str[1]) : 0;
+    return (str.size() * 11 + static_cast<unsigned char>(str.front()) * 14 + second + static_cast<unsigned char>(str.back()) * 27) % KEYWORD_TABLE_SIZE;
+}
+
+/**
+ * @brief Perfect hash table from a keyword to its id
+ */
+struct KeywordTable {
+    uint8_t ids[KEYWORD_TABLE_SIZE];  //! id of the keyword in each slot, or NO_KEYWORD
+    bool perfect;                     //! If true, no keywords share a slot
+};
+
+/**
+ * @brief Make the perfect hash table of keywords
+ * @return KeywordTable the table
+ */
+constexpr KeywordTable
+makeKeywordTable() {
+    KeywordTable table{};
+    for (auto& id : table.ids) {
+        id = NO_KEYWORD;
+    }
+
+    table.perfect = true;
+    for (size_t id = 0; id < sizeof(KEYWORDS) / sizeof(KEYWORDS[0]); id++) {
+        auto& slot = table.ids[::hashKeyword(KEYWORDS[id])];
+        if (slot != NO_KEYWORD)
+            table.perfect = false;
+        slot = static_cast<uint8_t>(id);
+    }
+
+    return table;
+}
+
+constexpr KeywordTable KEYWORD_TABLE = makeKeywordTable();
+
+static_assert(KEYWORD_TABLE.perfect, "keywords must not share a slot of KEYWORD_TABLE");
+
+}  // namespace
+
+namespace micro1 {
+
+/**
+ * @brief Find a keyword
+ *
+ * A keyword is found by a perfect hash, so it is neither hashed as a string
+ * nor looked up in a map.
+ *
+ * @param[in] str an identifier
+ * @return SymbolId id of the keyword, or NO_SYMBOL if str is not a keyword
+ */
+SymbolId
+findKeyword(std::string_view str) {
+    if (str.empty() || str.size() > MAX_KEYWORD_LENGTH)
+        return NO_SYMBOL;
+
+    const auto id = KEYWORD_TABLE.ids[::hashKeyword(str)];
+    if (id == NO_KEYWORD || KEYWORDS[id] != str)
+        return NO_SYMBOL;
+
+    return id;
+}
+
+/**
+ * @brief Constructor for Interner which interns all keywords
+ *
+ * Keywords take the ids from 0 in order of KEYWORDS, so they have the same
+ * ids in every interner.
+ */
+Interner::Interner() : m_strings(std::begin(KEYWORDS), std::end(KEYWORDS)) {
+    m_ids.reserve(256);
+}
+
+/**
+ * @brief Intern an identifier
+ *
+ * The string isn't copied, so it must outlive the interner.
+ *
+ * @param[in] str an identifier
+ * @return SymbolId id of the identifier (a new id if it is the first time)
+ */
+SymbolId
+Interner::intern(std::string_view str) {
+    if (auto id = findKeyword(str); id != NO_SYMBOL)
+        return id;
+
+    // emplace() allocates a node even if the identifier is interned already
+    if (auto it = m_ids.find(str); it != m_ids.end())
+        return it->second;
+
+    const auto id = static_cast<SymbolId>(m_strings.size());
+    m_ids.emplace(str, id);
+    m_strings.push_back(str);
+
+    return id;
+}
+
+/**
+ * @brief Find an identifier
+ * @param[in] str an identifier
+ * @return SymbolId id of the identifier, or NO_SYMBOL if it isn't interned
+ */
+SymbolId
+Interner::find(std::string_view str) const {
+    if (auto id = findKeyword(str); id != NO_SYMBOL)
+        return id;
+
+    if (auto it = m_ids.find(str); it != m_ids.end())
+        return it->second;
+
+    return NO_SYMBOL;
+}
+
+}  // namespace micro1
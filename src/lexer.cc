@@ -27,94 +27,302 @@
 
 #include "micro1-as/lexer.h"
 
-#include <cctype>
-#include <iostream>
+#include "micro1-as/charclass.h"
+#include "micro1-as/scanner.h"
 
-namespace micro1 {
+#include <algorithm>
+#include <memory>
+
+namespace {
 
 /**
- * @brief tokenize a source program
- * @param[in] ifs a source program
- * @return Tokens lexical tokens
+ * @brief tokenize a line of a source program
+ * @param[in] line a line without the new line
+ * @param[in] end end of the source program
+ * @param[out] tokens lexical tokens of the line are appended as a new line
  */
-Tokens
-tokenize(std::ifstream& ifs) {
-    Tokens tokens;
-
-    std::string line;
-    for (uint64_t row = 1; std::getline(ifs, line); row++) {
-        for (uint64_t pos = 0; pos < line.length(); pos++) {
-            // if line[pos] is whitespace, it's ignored.
-            if (std::isspace(line[pos])) {
-                continue;
-            }
+void
+tokenizeLine(std::string_view line, const char* end, micro1::TokenStore& tokens) {
+    tokens.addLine(line);
 
-            // if line[pos] is comment, it's skipped.
-            if (line[pos] == ';') {
-                break;
-            }
+    for (uint64_t pos = 0; pos < line.length(); pos++) {
+        // whitespaces are ignored. A run of them stops at the new line.
+        pos = static_cast<uint64_t>(micro1::skipBlanks(line.data() + pos, end) - line.data());
+        if (pos >= line.length()) {
+            break;
+        }
+
+        const auto cls = micro1::charClass(line[pos]);
+
+        // if line[pos] is comment, it's skipped.
+        if (cls == micro1::CharClass::SEMICOLON) {
+            break;
+        }
 
-            switch (line[pos]) {
-                case '(':
-                    tokens.emplace_back(Token(TokenKind::LPAREN, line, 1, row, pos));
-                    break;
-                case ')':
-                    tokens.emplace_back(Token(TokenKind::RPAREN, line, 1, row, pos));
-                    break;
-                case '*':
-                    tokens.emplace_back(Token(TokenKind::STAR, line, 1, row, pos));
-                    break;
-                case '+':
-                    [[fallthrough]];
-                case '-':
-                    tokens.emplace_back(Token(TokenKind::SIGN, line, 1, row, pos));
-                    break;
-                case ',':
-                    tokens.emplace_back(Token(TokenKind::COMMA, line, 1, row, pos));
-                    break;
-                case ':':
-                    tokens.emplace_back(Token(TokenKind::COLON, line, 1, row, pos));
-                    break;
-                case '\'':
-                    if (pos + 2 < line.length()) {
-                        tokens.emplace_back(Token(TokenKind::CHARS, line, 3, row, pos));
-                        pos += 2;
-                    } else {
-                        tokens.emplace_back(Token(TokenKind::INVALID, line, 1, row, pos));
-                    }
-                    break;
-                case '"':
-                    tokens.emplace_back(Token(TokenKind::DQUOTE, line, 1, row, pos));
-                    break;
-                default: {
-                    auto start = pos;
-                    if (std::isdigit(line[pos])) {
-                        while (++pos < line.length()) {
-                            if (!(std::isxdigit(line[pos])))
-                                break;
-                        }
-                        tokens.emplace_back(Token(TokenKind::INTEGER, line, pos - start, row, start));
-                        pos--;
-                    } else if (std::isalpha(line[pos])) {
-                        while (++pos < line.length()) {
-                            if (!std::isalnum(line[pos]))
-                                break;
-                        }
-                        tokens.emplace_back(Token(TokenKind::STRING, line, pos - start, row, start));
-                        pos--;
-                    } else {
-                        tokens.emplace_back(Token(TokenKind::INVALID, line, 1, row, pos));
-                    }
-
-                    break;
+        switch (cls) {
+            case micro1::CharClass::LPAREN:
+                tokens.add(micro1::TokenKind::LPAREN, pos, 1);
+                break;
+            case micro1::CharClass::RPAREN:
+                tokens.add(micro1::TokenKind::RPAREN, pos, 1);
+                break;
+            case micro1::CharClass::STAR:
+                tokens.add(micro1::TokenKind::STAR, pos, 1);
+                break;
+            case micro1::CharClass::SIGN:
+                tokens.add(micro1::TokenKind::SIGN, pos, 1);
+                break;
+            case micro1::CharClass::COMMA:
+                tokens.add(micro1::TokenKind::COMMA, pos, 1);
+                break;
+            case micro1::CharClass::COLON:
+                tokens.add(micro1::TokenKind::COLON, pos, 1);
+                break;
+            case micro1::CharClass::QUOTE:
+                if (pos + 2 < line.length()) {
+                    tokens.add(micro1::TokenKind::CHARS, pos, 3);
+                    pos += 2;
+                } else {
+                    tokens.add(micro1::TokenKind::INVALID, pos, 1);
                 }
+                break;
+            case micro1::CharClass::DQUOTE:
+                tokens.add(micro1::TokenKind::DQUOTE, pos, 1);
+                break;
+            case micro1::CharClass::DIGIT: {
+                auto start = pos;
+                pos = static_cast<uint64_t>(micro1::skipXDigits(line.data() + pos + 1, end) - line.data());
+                tokens.add(micro1::TokenKind::INTEGER, start, pos - start);
+                pos--;
+                break;
+            }
+            case micro1::CharClass::ALPHA: {
+                auto start = pos;
+                pos = static_cast<uint64_t>(micro1::skipAlnums(line.data() + pos + 1, end) - line.data());
+                tokens.add(micro1::TokenKind::STRING, start, pos - start);
+                pos--;
+                break;
             }
+            default:
+                tokens.add(micro1::TokenKind::INVALID, pos, 1);
+                break;
         }
+    }
+
+    tokens.add(micro1::TokenKind::EOL, line.length(), 0);
+}
+
+/**
+ * @brief tokenize lines of a source program
+ * @param[in] head first line
+ * @param[in] end end of the lines
+ * @param[out] tokens lexical tokens of the lines are appended
+ */
+void
+tokenizeLines(const char* head, const char* const end, micro1::TokenStore& tokens) {
+    while (head < end) {
+        const char* tail = micro1::findEOL(head, end);
+        const auto line = std::string_view(head, static_cast<size_t>(tail - head));
+        head = tail + 1;
 
-        tokens.emplace_back(Token(TokenKind::EOL, line, 1, row, line.length()));
+        ::tokenizeLine(line, end, tokens);
     }
+}
+
+}  // namespace
+
+namespace micro1 {
+
+/**
+ * @brief tokenize a source program
+ * @param[in] source a source program
+ * @return Tokens lexical tokens which refer to source
+ */
+TokenStore
+tokenize(const SourceBuffer& source) {
+    return tokenize(source.data());
+}
+
+/**
+ * @brief tokenize a source program in memory
+ * @param[in] data bytes of a source program
+ * @return Tokens lexical tokens which refer to data
+ */
+TokenStore
+tokenize(std::string_view data) {
+    TokenStore tokens;
+
+    tokens.clear(data.data(), 1);
+    ::tokenizeLines(data.data(), data.data() + data.size(), tokens);
 
     return tokens;
 }
 
+/**
+ * @brief tokenize a source program in memory
+ * @param[in] bytes bytes of a source program
+ * @param[in] size number of bytes
+ * @return Tokens lexical tokens which refer to bytes
+ */
+TokenStore
+tokenize(const unsigned char* bytes, size_t size) {
+    return tokenize(std::string_view(reinterpret_cast<const char*>(bytes), size));
+}
+
+/**
+ * @brief tokenize a source program read from a stream
+ * @param[in] is a source program
+ * @return Tokens lexical tokens which refer to a copy of the program held by themselves
+ */
+TokenStore
+tokenize(std::istream& is) {
+    auto source = std::make_shared<const SourceBuffer>(is);
+    auto tokens = tokenize(*source);
+    tokens.hold(std::move(source));
+
+    return tokens;
+}
+
+/**
+ * @brief Split a source program into chunks at new lines
+ * @param[in] data bytes of a source program
+ * @param[in] pool threads which process the chunks
+ * @return std::vector<SourceChunk> chunks in order (only one if the program is small or the pool has no worker)
+ */
+std::vector<SourceChunk>
+splitSource(std::string_view data, ThreadPool& pool) {
+    const char* const begin = data.data();
+    const char* const end = begin + data.size();
+
+    // a few chunks per thread balance long and short lines
+    size_t count = std::min<size_t>(pool.size() * 4, data.size() / MIN_CHUNK_SIZE);
+    if (pool.size() == 1 || count <= 1)
+        return {{data, 1}};
+
+    std::vector<const char*> bounds(count + 1, end);
+    bounds[0] = begin;
+    for (size_t i = 1; i < count; i++) {
+        const char* head = std::max(begin + data.size() / count * i, bounds[i - 1]);
+        const char* eol = findEOL(head, end);
+        bounds[i] = eol < end ? eol + 1 : end;
+    }
+
+    // row numbers of the chunks are the prefix sum of their new lines
+    std::vector<uint64_t> rows(count + 1, 0);
+    pool.run(count, [&bounds, &rows](size_t i) {
+        rows[i + 1] = static_cast<uint64_t>(std::count(bounds[i], bounds[i + 1], '\n'));
+    });
+    rows[0] = 1;
+    for (size_t i = 1; i <= count; i++) {
+        rows[i] += rows[i - 1];
+    }
+
+    std::vector<SourceChunk> chunks;
+    chunks.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        chunks.push_back({std::string_view(bounds[i], static_cast<size_t>(bounds[i + 1] - bounds[i])), rows[i]});
+    }
+
+    return chunks;
+}
+
+/**
+ * @brief tokenize a source program in parallel
+ *
+ * The source program is split into chunks at new lines. The chunks are
+ * tokenized by the pool, and their tokens are concatenated in order.
+ *
+ * @param[in] source a source program
+ * @param[in] pool threads which tokenize chunks
+ * @return Tokens lexical tokens which refer to source (same as tokenize(source))
+ */
+TokenStore
+tokenize(const SourceBuffer& source, ThreadPool& pool) {
+    const char* const begin = source.data().data();
+
+    const auto sources = splitSource(source.data(), pool);
+    if (sources.size() == 1)
+        return tokenize(source);
+
+    std::vector<TokenStore> chunks(sources.size());
+    pool.run(sources.size(), [begin, &sources, &chunks](size_t i) {
+        const auto& chunk = sources[i];
+        chunks[i].clear(begin, chunk.first_row);
+        ::tokenizeLines(chunk.data.data(), chunk.data.data() + chunk.data.size(), chunks[i]);
+    });
+
+    TokenStore tokens;
+    tokens.clear(begin, 1);
+    for (const auto& chunk : chunks) {
+        tokens.append(chunk);
+    }
+
+    return tokens;
+}
+
+/**
+ * @brief Construct TokenStream which tokenizes a source program line by line
+ * @param[in] source a source program
+ */
+TokenStream::TokenStream(const SourceBuffer& source) : TokenStream(source.data()) {}
+
+/**
+ * @brief Construct TokenStream which tokenizes a source program in memory line by line
+ * @param[in] data bytes of a source program
+ * @param[in] first_row row number of the first line (e.g. of a chunk)
+ */
+TokenStream::TokenStream(std::string_view data, uint64_t first_row)
+    : m_store(&m_line), m_head(0), m_tail(0), m_next(data.data()),
+      m_end(data.data() + data.size()), m_row(first_row - 1), m_lazy(true) {
+    fill();
+}
+
+/**
+ * @brief Construct TokenStream which reads tokens tokenized in advance
+ * @param[in] tokens lexical tokens
+ */
+TokenStream::TokenStream(const TokenStore& tokens)
+    : m_store(&tokens), m_head(0), m_tail(tokens.size()), m_next(nullptr), m_end(nullptr),
+      m_row(0), m_lazy(false) {}
+
+/**
+ * @brief Go to the next token
+ *
+ * When all tokens of the current line are consumed, the next line is tokenized.
+ */
+void
+TokenStream::next() {
+    if (m_head == m_tail)
+        return;
+
+    m_head++;
+    if (m_head == m_tail && m_lazy)
+        fill();
+}
+
+/**
+ * @brief Tokenize the next line into the line buffer
+ *
+ * The buffer of tokens is reused, so it is bounded by the longest line.
+ * The interner keeps identifiers of all lines read so far, so it grows with
+ * the number of distinct identifiers.
+ */
+void
+TokenStream::fill() {
+    if (m_next < m_end) {
+        const char* tail = findEOL(m_next, m_end);
+        const auto line = std::string_view(m_next, static_cast<size_t>(tail - m_next));
+        m_next = tail + 1;
+
+        // offsets of the buffer are relative to the line, so they never overflow
+        m_line.clear(line.data(), ++m_row);
+        ::tokenizeLine(line, m_end, m_line);
+    } else {
+        m_line.clear(m_end, m_row);
+    }
+
+    m_head = 0;
+    m_tail = m_line.size();
+}
+
 }  // namespace micro1
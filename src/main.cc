@@ -26,16 +26,20 @@
  */
 
 #include "micro1-as/backend.h"
+#include "micro1-as/context.h"
 #include "micro1-as/lexer.h"
 #include "micro1-as/parser.h"
-#include "micro1-as/symbol.h"
+#include "micro1-as/thread_pool.h"
 #include "micro1-as/version.h"
 
+#include <algorithm>
 #include <cctype>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <numeric>
+#include <stdexcept>
 #include <string>
 
 using std::cerr;
@@ -69,8 +73,41 @@ void
 printUsage() {
     cout << "Usage: micro1-as                (interactive mode)" << endl;
     cout << " Or  : micro1-as <source_code>  (command mode)" << endl;
+    cout << " Or  : micro1-as -              (command mode; read stdin and write the object to stdout)" << endl;
     cout << " Or  : micro1-as (-v|--version) (print version)" << endl;
     cout << " Or  : micro1-as (-h|--help)    (help mode; print this message)" << endl;
+    cout << endl;
+    cout << "Options of command mode:" << endl;
+    cout << "  --error-limit=N    stop assembling at N syntax errors (0: no limit)" << endl;
+    cout << "  --fail-fast        stop assembling at the first syntax error (--error-limit=1)" << endl;
+    cout << "  --cross-reference  write the listing file (.a) with the cross reference of labels" << endl;
+}
+
+/**
+ * @brief Get the error limit from a command line option
+ * @param[in] option a command line option (--error-limit=N or --fail-fast)
+ * @param[out] error_limit number of syntax errors which stops assembling (0: no limit)
+ * @return bool If false, the option is unknown
+ */
+bool
+getErrorLimit(const string option, size_t& error_limit) {
+    const string prefix = "--error-limit=";
+
+    if (option == "--fail-fast") {
+        error_limit = 1;
+        return true;
+    } else if (option.compare(0, prefix.size(), prefix) == 0 && option.size() > prefix.size() &&
+               std::all_of(option.begin() + static_cast<std::ptrdiff_t>(prefix.size()), option.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+        // digits which don't fit in unsigned long long are not an error limit
+        try {
+            error_limit = static_cast<size_t>(std::stoull(option.substr(prefix.size())));
+        } catch (const std::out_of_range&) {
+            return false;
+        }
+        return true;
+    }
+
+    return false;
 }
 
 /**
@@ -87,37 +124,88 @@ removeExtension(const string filename) {
     }
 }
 
+/**
+ * @brief Return threads for a source program
+ *
+ * The threads are made at the first source program which is large enough
+ * to be split into chunks, and are shared by the following ones.
+ *
+ * @param[in] source a source program
+ * @return micro1::ThreadPool* threads, or nullptr if the source program is too small to be split
+ */
+micro1::ThreadPool*
+getThreadPool(const micro1::SourceBuffer& source) {
+    static std::unique_ptr<micro1::ThreadPool> pool;
+
+    if (source.size() < 2 * micro1::MIN_CHUNK_SIZE)
+        return nullptr;
+    if (!pool)
+        pool = std::make_unique<micro1::ThreadPool>();
+
+    return pool.get();
+}
+
 /**
  * @brief Assemble MICRO-1 source program
- * @param[in] filename a file name which source program
+ *
+ * If the number of syntax errors reaches error_limit, the rest of the
+ * source program is neither tokenized nor parsed, and the errors are printed
+ * without resolving symbols and writing files.
+ *
+ * @param[in] filename a file name which source program ("-": standard input)
  * @param[in] mode If 'w', write a listing file. If 'p', print syntax errors.
+ * @param[in] error_limit number of syntax errors which stops assembling (0: no limit)
+ * @param[in] cross_reference If true, write a listing file with the cross reference of labels
  * @return bool if true, the source program is correct syntactically
  */
 bool
-assemble(const string filename, const char mode) {
-    std::ifstream ifs(filename);
-    if (ifs.fail()) {
+assemble(const string filename, const char mode, const size_t error_limit = 0, const bool cross_reference = false) {
+    const bool from_stdin = (filename == "-");
+
+    micro1::SourceBuffer source;
+    if (from_stdin ? !source.read(cin) : !source.open(filename)) {
         cerr << "ERROR: FILE NOT FOUND" << endl;
         return false;
     }
 
-    auto tokens = micro1::tokenize(ifs);
-    auto rows = micro1::parse(tokens);
-    rows = micro1::resolveSymbols(rows);
+    // every stage shares the rows and the symbol table of the context
+    micro1::AssemblyContext context(source);
+    auto pool = getThreadPool(source);
+    if (pool)
+        context.parse(*pool, error_limit);
+    else
+        context.parse(error_limit);
+
+    if (error_limit != 0 && context.diagnostics().size() >= error_limit) {
+        micro1::printDiagnostics(context);
+        cerr << "ERROR: ASSEMBLING STOPPED AT " << context.diagnostics().size() << " ERROR(S)" << endl;
+        return false;
+    }
+
+    if (pool)
+        context.resolve(*pool);
+    else
+        context.resolve();
 
+    const string listing = from_stdin ? "stdin.a" : removeExtension(filename) + ".a";
     switch (mode) {
         case 'w':
-            micro1::writeListingFile(rows, removeExtension(filename) + ".a");
+            micro1::writeListingFile(context, listing, cross_reference);
             break;
         case 'p':
-            micro1::printSyntaxError(rows);
+            micro1::printSyntaxError(context);
+            if (cross_reference)
+                micro1::writeListingFile(context, listing, true);
             break;
         default:
             cerr << "WARNING: mode `" << mode << "` not found." << endl;
             break;
     }
 
-    return micro1::writeObjectFile(rows, removeExtension(filename) + ".b");
+    if (from_stdin)
+        return micro1::writeObjectFile(context, cout);
+
+    return micro1::writeObjectFile(context, removeExtension(filename) + ".b");
 }
 
 /**
@@ -161,7 +249,20 @@ main(const int argc, const char **argv) {
             } while (yn != 'y' && yn != 'n');
         } while (yn == 'y');
     } else if (mode == "command") {
-        if (!assemble(string(argv[1]), 'p'))
+        size_t error_limit = 0;
+        bool cross_reference = false;
+        int i = 1;
+        for (; i + 1 < argc; i++) {
+            if (string(argv[i]) == "--cross-reference") {
+                cross_reference = true;
+            } else if (!getErrorLimit(string(argv[i]), error_limit)) {
+                cerr << "ERROR: UNKNOWN OPTION `" << argv[i] << "`" << endl;
+                printUsage();
+                return 2;
+            }
+        }
+
+        if (!assemble(string(argv[i]), 'p', error_limit, cross_reference))
             return 1;
     }
 
@@ -27,16 +27,19 @@
 
 #include "micro1-as/parser.h"
 
+#include "micro1-as/charclass.h"
 #include "micro1-as/instruction.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
 
 namespace {
 
-using TokenIterator = micro1::Tokens::iterator;
-
-enum class State {
+enum class State : uint8_t {
     WAIT_TITLE,
     LOAD_TITLE_NAME,
     LOAD_TITLE_EOL,
@@ -66,636 +69,875 @@ enum class State {
     FINAL
 };
 
+const size_t NUMBER_OF_STATES = static_cast<size_t>(State::FINAL) + 1;
+const size_t NUMBER_OF_TOKEN_KINDS = static_cast<size_t>(micro1::TokenKind::INVALID) + 1;
+
 void
-skipToEOL(TokenIterator& iter, const TokenIterator end) {
-    for (; iter < end; iter++) {
-        if ((*iter).kind() == micro1::TokenKind::EOL)
+skipToEOL(micro1::TokenStream& stream) {
+    for (; !stream.eof(); stream.next()) {
+        if (stream.peek().kind() == micro1::TokenKind::EOL)
             break;
     }
 }
 
+/**
+ * @brief Copy tokens of an instruction into an arena
+ *
+ * The instruction is built in a vector which is reused for every line, so
+ * a row takes one allocation of the exact size (none from the heap if the
+ * arena is given).
+ */
+micro1::Tokens
+copyTokens(const micro1::Tokens& instruction, micro1::Arena* arena) {
+    return micro1::Tokens(instruction.begin(), instruction.end(), micro1::ArenaAllocator<micro1::Token>(arena));
+}
+
+/**
+ * @brief Append a row which takes over tokens and operands of the instruction
+ *
+ * The instruction and the operands are left empty for the next line.
+ */
+void
+flushRow(micro1::Rows& rows, std::string_view label, micro1::M1Addr addr, micro1::Tokens& instruction, micro1::ReferenceAddress raddr, micro1::Operands& operands, micro1::Arena* arena) {
+    rows.emplace_back(label, addr, copyTokens(instruction, arena), raddr, operands);
+    instruction.clear();
+    operands = micro1::Operands();
+}
+
+micro1::Token
+advance(micro1::TokenStream& stream) {
+    stream.next();
+    return stream.peek().token();
+}
+
+bool
+hasOnly(std::string_view str, uint8_t flag) {
+    return std::all_of(str.begin(), str.end(), [flag](char c) { return micro1::hasCharFlag(c, flag); });
+}
+
 bool
-isDecimal(std::string str) {
-    return std::count_if(str.begin(), str.end(), [](unsigned char c) { return std::isdigit(c); }) == static_cast<int>(str.length());
+isDecimal(std::string_view str) {
+    return hasOnly(str, micro1::CHAR_DIGIT);
+}
+
+bool
+isHexadecimal(std::string_view str) {
+    return hasOnly(str, micro1::CHAR_XDIGIT);
+}
+
+bool
+isOctal(std::string_view str) {
+    return hasOnly(str, micro1::CHAR_OCTAL);
+}
+
+bool
+isBinary(std::string_view str) {
+    return hasOnly(str, micro1::CHAR_BINARY);
+}
+
+/**
+ * @brief Convert leading digits of a string into a number
+ *
+ * Like std::stoi(), it stops at the first character which isn't a digit of
+ * the base. A number which doesn't fit is wrapped instead of thrown.
+ *
+ * @param[in] str digits
+ * @param[in] base 2, 8, 10 or 16
+ * @return uint32_t the number
+ */
+uint32_t
+toNumber(std::string_view str, uint32_t base) {
+    uint32_t number = 0;
+
+    for (char c : str) {
+        uint32_t digit;
+        if (micro1::hasCharFlag(c, micro1::CHAR_DIGIT))
+            digit = static_cast<uint32_t>(c - '0');
+        else if (micro1::hasCharFlag(c, micro1::CHAR_XDIGIT))
+            digit = static_cast<uint32_t>((c | 0x20) - 'a' + 10);
+        else
+            break;
+
+        if (digit >= base)
+            break;
+        number = number * base + digit;
+    }
+
+    return number;
 }
 
+/**
+ * @brief Convert decimal digits of an offset of an address
+ * @param[in] str decimal digits
+ * @param[out] offset the offset
+ * @return bool If false, the offset doesn't fit in an address
+ */
 bool
-isHexadecimal(std::string str) {
-    return std::count_if(str.begin(), str.end(), [](unsigned char c) { return std::isxdigit(c); }) == static_cast<int>(str.length());
+toOffset(std::string_view str, int64_t& offset) {
+    // leading zeros don't make an offset larger
+    str.remove_prefix(std::min(str.find_first_not_of('0'), str.size()));
+    if (str.size() > 5)
+        return false;
+
+    offset = ::toNumber(str, 10);
+    return offset <= UINT16_MAX;
 }
 
+/*
+ * The following helpers look at the n-th token ahead of the current one.
+ * None of them looks beyond the end of the current line, so a line never
+ * borrows an operand from the next one.
+ */
+
 bool
-isOctal(std::string str) {
-    return std::count_if(str.begin(), str.end(), [](unsigned char c) { return '0' <= c && c < '8'; }) == static_cast<int>(str.length());
+isOperand(micro1::TokenRef token) {
+    return token && token.kind() != micro1::TokenKind::EOL;
 }
 
 bool
-isBinary(std::string str) {
-    return std::count_if(str.begin(), str.end(), [](unsigned char c) { return c == '0' || c == '1'; }) == static_cast<int>(str.length());
+expectColon(const micro1::TokenStream& stream, size_t n) {
+    auto head = stream.peek(n);
+    return head && head.kind() == micro1::TokenKind::COLON;
 }
 
 bool
-expectPrefix(TokenIterator head, const TokenIterator tail) {
-    if (head + 1 >= tail)
+expectPrefix(const micro1::TokenStream& stream, size_t n) {
+    auto head = stream.peek(n);
+    auto quote = stream.peek(n + 1);
+    if (!head || !quote)
         return false;
 
-    if ((*head).kind() != micro1::TokenKind::STRING || (*(head + 1)).kind() != micro1::TokenKind::DQUOTE) {
+    if (head.kind() != micro1::TokenKind::STRING || quote.kind() != micro1::TokenKind::DQUOTE) {
         return false;
     }
 
-    return (*head).str() == "X" || (*head).str() == "O" || (*head).str() == "B";
+    return head.is(micro1::Keyword::X) || head.is(micro1::Keyword::O) || head.is(micro1::Keyword::B);
 }
 
 bool
-expectUInt(TokenIterator head, const TokenIterator tail) {
-    if (head >= tail)
+expectUInt(const micro1::TokenStream& stream, size_t n) {
+    auto head = stream.peek(n);
+    if (!head)
         return false;
 
-    if ((*head).kind() == micro1::TokenKind::INTEGER) {
-        return isDecimal((*head).str());
-    } else if ((*head).kind() == micro1::TokenKind::STRING) {
-        if (!expectPrefix(head, tail))
+    if (head.kind() == micro1::TokenKind::INTEGER) {
+        return isDecimal(head.str());
+    } else if (head.kind() == micro1::TokenKind::STRING) {
+        if (!expectPrefix(stream, n))
             return false;
 
-        if ((*head).str() == "X")
-            return isHexadecimal((*(head + 2)).str());
-        if ((*head).str() == "O")
-            return isOctal((*(head + 2)).str());
-        if ((*head).str() == "B")
-            return isBinary((*(head + 2)).str());
+        // the digits must follow the prefix on the same line
+        auto digits = stream.peek(n + 2);
+        if (!isOperand(digits))
+            return false;
+
+        if (head.is(micro1::Keyword::X))
+            return isHexadecimal(digits.str());
+        if (head.is(micro1::Keyword::O))
+            return isOctal(digits.str());
+        if (head.is(micro1::Keyword::B))
+            return isBinary(digits.str());
     }
 
     return false;
 }
 
 bool
-expectSInt(TokenIterator head, const TokenIterator tail) {
-    if (head >= tail)
+expectSInt(const micro1::TokenStream& stream, size_t n) {
+    auto head = stream.peek(n);
+    if (!head)
         return false;
 
-    if ((*head).kind() == micro1::TokenKind::SIGN)
-        head++;
+    if (head.kind() == micro1::TokenKind::SIGN)
+        n++;
+
+    return expectUInt(stream, n);
+}
+
+/**
+ * @brief Read an unsigned integer which expectUInt() accepts
+ * @return micro1::M1Word the integer
+ */
+micro1::M1Word
+readUInt(const micro1::TokenStream& stream, size_t n) {
+    auto head = stream.peek(n);
+    if (head.kind() == micro1::TokenKind::INTEGER)
+        return static_cast<micro1::M1Word>(toNumber(head.str(), 10));
+
+    uint32_t base = 16;
+    if (head.is(micro1::Keyword::O))
+        base = 8;
+    else if (head.is(micro1::Keyword::B))
+        base = 2;
+
+    return static_cast<micro1::M1Word>(toNumber(stream.peek(n + 2).str(), base));
+}
 
-    return expectUInt(head, tail);
+/**
+ * @brief Read a signed integer which expectSInt() accepts
+ * @return micro1::M1Word the integer in two's complement
+ */
+micro1::M1Word
+readSInt(const micro1::TokenStream& stream, size_t n) {
+    auto head = stream.peek(n);
+    if (head.kind() != micro1::TokenKind::SIGN)
+        return readUInt(stream, n);
+
+    auto value = readUInt(stream, n + 1);
+    return static_cast<micro1::M1Word>(head.str() == "+" ? value : 0x10000 - value);
 }
 
 bool
-expectAddress(TokenIterator head, const TokenIterator tail) {
-    if (head >= tail)
+expectAddress(const micro1::TokenStream& stream, size_t n) {
+    auto head = stream.peek(n);
+    if (!head)
         return false;
 
     // it is expected that first token is star or string
-    if ((*head).kind() != micro1::TokenKind::STAR && (*head).kind() != micro1::TokenKind::STRING)
+    if (head.kind() != micro1::TokenKind::STAR && head.kind() != micro1::TokenKind::STRING)
         return false;
 
     // if second token is sign, third token is decimal number
-    if ((*(head + 1)).kind() != micro1::TokenKind::SIGN)
+    auto sign = stream.peek(n + 1);
+    if (!sign || sign.kind() != micro1::TokenKind::SIGN)
         return true;
 
-    return isDecimal((*(head + 2)).str());
+    auto digits = stream.peek(n + 2);
+    return isOperand(digits) && isDecimal(digits.str());
 }
 
 bool
-expectConstant(TokenIterator head, const TokenIterator tail) {
-    if (head >= tail)
+expectConstant(const micro1::TokenStream& stream, size_t n) {
+    auto head = stream.peek(n);
+    if (!head)
         return false;
 
     // signed integer
-    if (expectSInt(head, tail))
+    if (expectSInt(stream, n))
         return true;
 
     // two characters
-    if ((*head).kind() == micro1::TokenKind::CHARS)
+    if (head.kind() == micro1::TokenKind::CHARS)
         return true;
 
     // address label
-    return (*head).kind() == micro1::TokenKind::STRING;
+    return head.kind() == micro1::TokenKind::STRING;
 }
 
-}  // namespace
+void
+takeNumber(micro1::TokenStream& stream, micro1::Tokens& instruction) {
+    if (stream.peek().kind() == micro1::TokenKind::SIGN) {
+        instruction.emplace_back(::advance(stream));
+    }
+    if (::expectPrefix(stream, 0)) {
+        instruction.emplace_back(::advance(stream));
+        instruction.emplace_back(::advance(stream));
+    }
+}
 
-namespace micro1 {
+/**
+ * @brief What the parser does with a token
+ */
+enum class Action : uint8_t {
+    SHIFT,        //! take the token
+    RB,           //! take an integer for rb register
+    RA,           //! take an integer for ra register
+    PASS,         //! ignore the token
+    BLANK,        //! emit an empty row
+    REJECT,       //! emit an error row and skip the rest of the line
+    ACCEPT,       //! emit a row which takes no word (TITLE, END)
+    EMIT,         //! emit an instruction and count its words
+    TITLE,        //! take TITLE
+    LABEL,        //! take a label, or leave an opecode to LOAD_OPECODE
+    OPECODE,      //! take an opecode and select operands by its group
+    COMMA,        //! take a comma and select operands by the group
+    UINT,         //! take an unsigned integer with its prefix
+    SINT,         //! take a signed integer with its sign and prefix
+    ADDRESS,      //! take an address with its offset
+    DEVICE,       //! take a device name or number
+    CONSTANT,     //! take a constant value of DC
+    DECIMAL,      //! take a decimal of DS
+    HEXADECIMAL,  //! take a hexadecimal of ORG
+    FINISH        //! stop parsing (after END)
+};
 
 /**
- * @brief Parse lexical tokens
- * @param[in] tokens tokens which parsed by lexical analyzer
- * @return std::vector<Row> parsed tokens
+ * @brief Transition of the parser by a token
+ *
+ * When an action which tests the token (TITLE, UINT, ...) fails, the token is
+ * rejected with the diagnostic code and the parser goes to LOAD_LABEL.
  */
-Rows
-parse(Tokens tokens) {
-    ::State state = ::State::WAIT_TITLE;
-    std::string label;
-    M1Addr addr = 0;
-    std::string reference;
-    int64_t offset = 0;
-    Rows ret;
-    Tokens::iterator iter = tokens.begin();
-    Tokens instruction;
+struct Transition {
+    Action action;                //! what the parser does with the token
+    State next;                   //! state after the token is taken
+    micro1::DiagnosticCode code;  //! diagnostic when the token is rejected
+};
 
-    for (; iter < tokens.end(); iter++) {
-        switch (state) {
-            case ::State::WAIT_TITLE:
-                if ((*iter).kind() == TokenKind::EOL) {
-                    ret.emplace_back(Row("", addr, {}, DebugInfo(DebugInfoImportance::INFO, "", 0), ReferenceAddress("", 0, 0)));
-                } else if ((*iter).str() == "TITLE") {
-                    state = ::State::LOAD_TITLE_NAME;
-                    instruction.emplace_back(*iter);
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    instruction.emplace_back(*iter);
-                    ret.emplace_back(Row("", addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required \"TITLE\".", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    ::skipToEOL(iter, tokens.end());
-                }
+/**
+ * @brief Table of transitions indexed by a state and a token kind
+ */
+struct TransitionTable {
+    Transition entries[NUMBER_OF_STATES][NUMBER_OF_TOKEN_KINDS];  //! transitions
+};
 
-                break;
-            case ::State::LOAD_TITLE_NAME:
-                instruction.emplace_back(*iter);
+constexpr void
+setTransition(TransitionTable& table, State state, Transition transition) {
+    for (size_t kind = 0; kind < NUMBER_OF_TOKEN_KINDS; kind++)
+        table.entries[static_cast<size_t>(state)][kind] = transition;
+}
 
-                if ((*iter).kind() == TokenKind::STRING) {
-                    state = ::State::LOAD_TITLE_EOL;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row("", addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required title name.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    ::skipToEOL(iter, tokens.end());
-                }
+constexpr void
+setTransition(TransitionTable& table, State state, micro1::TokenKind kind, Transition transition) {
+    table.entries[static_cast<size_t>(state)][static_cast<size_t>(kind)] = transition;
+}
 
-                break;
-            case ::State::LOAD_TITLE_EOL:
-                state = ::State::LOAD_LABEL;
+/**
+ * @brief Build TransitionTable
+ *
+ * Each state rejects any token first, then accepts the expected kinds.
+ *
+ * @return TransitionTable table of transitions
+ */
+constexpr TransitionTable
+makeTransitionTable() {
+    using micro1::DiagnosticCode;
+    using micro1::TokenKind;
+    TransitionTable table{};
 
-                if ((*iter).kind() == TokenKind::EOL) {
-                    ret.emplace_back(Row("", addr, instruction, DebugInfo(DebugInfoImportance::INFO, "", 0), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                } else {
-                    instruction.emplace_back(*iter);
-                    ret.emplace_back(Row("", addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Too many tokens.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    ::skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::WAIT_TITLE, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_TITLE});
+    setTransition(table, State::WAIT_TITLE, TokenKind::EOL, {Action::BLANK, State::WAIT_TITLE, DiagnosticCode::NONE});
+    setTransition(table, State::WAIT_TITLE, TokenKind::STRING, {Action::TITLE, State::LOAD_TITLE_NAME, DiagnosticCode::REQUIRED_TITLE});
 
-                break;
-            case ::State::LOAD_LABEL:
-                if ((*iter).kind() == TokenKind::EOL) {
-                    ret.emplace_back(Row("", addr, {}, DebugInfo(DebugInfoImportance::INFO, "", 0), ReferenceAddress("", 0, 0)));
-                } else if ((*iter).kind() == TokenKind::STRING) {
-                    state = ::State::LOAD_COLON;
-                    label = (*iter).str();
-                    reference = "";
-                    offset = 0;
-                } else {
-                    instruction.emplace_back(*iter);
-                    ret.emplace_back(Row("", addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required label name or opecode.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    ::skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::LOAD_TITLE_NAME, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_TITLE_NAME});
+    setTransition(table, State::LOAD_TITLE_NAME, TokenKind::STRING, {Action::SHIFT, State::LOAD_TITLE_EOL, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_COLON:
-                state = ::State::LOAD_OPECODE;
+    setTransition(table, State::LOAD_TITLE_EOL, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::TOO_MANY_TOKENS});
+    setTransition(table, State::LOAD_TITLE_EOL, TokenKind::EOL, {Action::ACCEPT, State::LOAD_LABEL, DiagnosticCode::NONE});
 
-                if ((*iter).kind() != TokenKind::COLON) {
-                    label = "";
-                    iter -= 2;
-                }
+    setTransition(table, State::LOAD_LABEL, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_LABEL_OR_OPECODE});
+    setTransition(table, State::LOAD_LABEL, TokenKind::EOL, {Action::BLANK, State::LOAD_LABEL, DiagnosticCode::NONE});
+    setTransition(table, State::LOAD_LABEL, TokenKind::STRING, {Action::LABEL, State::LOAD_COLON, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_OPECODE:
-                instruction.emplace_back(*iter);
-
-                if ((*iter).kind() != TokenKind::STRING) {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required opecode.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                } else {
-                    switch (getNumberOfGroup((*iter).str())) {
-                        case InstGroup::GROUP1:
-                            [[fallthrough]];
-                        case InstGroup::GROUP2:
-                            [[fallthrough]];
-                        case InstGroup::GROUP3:
-                            [[fallthrough]];
-                        case InstGroup::GROUP4:
-                            [[fallthrough]];
-                        case InstGroup::GROUP5:
-                            state = ::State::LOAD_RB;
-                            break;
-                        case InstGroup::GROUP6:
-                            state = ::State::LOAD_OP6_ADDRESS;
-                            break;
-                        case InstGroup::GROUP7:
-                            state = ::State::LOAD_OP7_DEVICE;
-                            break;
-                        case InstGroup::GROUP8:
-                            state = ::State::LOAD_INST_EOL;
-                            break;
-                        case InstGroup::GROUP9:
-                            if ((*iter).str() == "DC") {
-                                state = ::State::LOAD_DC_OPERAND;
-                            } else if ((*iter).str() == "DS") {
-                                state = ::State::LOAD_DS_OPERAND;
-                            } else /* if ((*iter).str() == "ORG") */ {
-                                state = ::State::LOAD_ORG_OPERAND;
-                            }
-
-                            break;
-                        default:
-                            if ((*iter).str() == "END") {
-                                state = ::State::LOAD_END_EOL;
-                            } else {
-                                state = ::State::LOAD_LABEL;
-                                ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Unknown opecode.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                                instruction.clear();
-                                skipToEOL(iter, tokens.end());
-                            }
-
-                            break;
-                    }
-                }
+    setTransition(table, State::LOAD_COLON, {Action::PASS, State::LOAD_OPECODE, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_RB:
-                instruction.emplace_back(*iter);
+    setTransition(table, State::LOAD_OPECODE, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_OPECODE});
+    setTransition(table, State::LOAD_OPECODE, TokenKind::STRING, {Action::OPECODE, State::LOAD_LABEL, DiagnosticCode::UNKNOWN_OPECODE});
 
-                if ((*iter).kind() == TokenKind::INTEGER) {
-                    state = ::State::LOAD_COMMA;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required integer for rb register.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::LOAD_RB, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_RB});
+    setTransition(table, State::LOAD_RB, TokenKind::INTEGER, {Action::RB, State::LOAD_COMMA, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_COMMA:
-                instruction.emplace_back(*iter);
-
-                if ((*iter).kind() == TokenKind::COMMA) {
-                    switch (getNumberOfGroup((*(iter - 2)).str())) {
-                        case InstGroup::GROUP1:
-                            state = ::State::LOAD_OP1_OPERAND;
-                            break;
-                        case InstGroup::GROUP2:
-                            state = ::State::LOAD_OP2_OPERAND;
-                            break;
-                        case InstGroup::GROUP3:
-                            state = ::State::LOAD_OP3_OPERAND;
-                            break;
-                        case InstGroup::GROUP4:
-                            state = ::State::LOAD_OP4_OPERAND;
-                            break;
-                        default:  // case InstGroup::GROUP5:
-                            state = ::State::LOAD_OP5_ADDRESS;
-                            break;
-                    }
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required comma.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::LOAD_COMMA, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_COMMA});
+    setTransition(table, State::LOAD_COMMA, TokenKind::COMMA, {Action::COMMA, State::LOAD_LABEL, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_OP1_OPERAND:
-                instruction.emplace_back(*iter);
-
-                if ((*iter).kind() == TokenKind::LPAREN) {
-                    state = ::State::LOAD_OP1_RA;
-                } else if (::expectUInt(iter, tokens.end())) {
-                    state = ::State::LOAD_OP1_NEXT_OPERAND;
-                    if (::expectPrefix(iter, tokens.end())) {
-                        instruction.emplace_back(*(++iter));
-                        instruction.emplace_back(*(++iter));
-                    }
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required unsigned integer.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    // GROUP1: ra, unsigned integer[(rb)] or ra, (rb)
+    setTransition(table, State::LOAD_OP1_OPERAND, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_UINT});
+    setTransition(table, State::LOAD_OP1_OPERAND, TokenKind::LPAREN, {Action::SHIFT, State::LOAD_OP1_RA, DiagnosticCode::NONE});
+    setTransition(table, State::LOAD_OP1_OPERAND, TokenKind::INTEGER, {Action::UINT, State::LOAD_OP1_NEXT_OPERAND, DiagnosticCode::REQUIRED_UINT});
+    setTransition(table, State::LOAD_OP1_OPERAND, TokenKind::STRING, {Action::UINT, State::LOAD_OP1_NEXT_OPERAND, DiagnosticCode::REQUIRED_UINT});
 
-                break;
-            case ::State::LOAD_OP1_NEXT_OPERAND:
-                if ((*iter).kind() == TokenKind::LPAREN) {
-                    instruction.emplace_back(*iter);
-                    state = ::State::LOAD_OP1_RA;
-                } else if ((*iter).kind() == TokenKind::EOL) {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::INFO, "", 0), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    addr++;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    instruction.emplace_back(*iter);
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required an end of line or a left parenthesis.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::LOAD_OP1_NEXT_OPERAND, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_EOL_OR_LPAREN});
+    setTransition(table, State::LOAD_OP1_NEXT_OPERAND, TokenKind::LPAREN, {Action::SHIFT, State::LOAD_OP1_RA, DiagnosticCode::NONE});
+    setTransition(table, State::LOAD_OP1_NEXT_OPERAND, TokenKind::EOL, {Action::EMIT, State::LOAD_LABEL, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_OP1_RA:
-                instruction.emplace_back(*iter);
+    setTransition(table, State::LOAD_OP1_RA, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_RA});
+    setTransition(table, State::LOAD_OP1_RA, TokenKind::INTEGER, {Action::RA, State::LOAD_OP1_RPAREN, DiagnosticCode::NONE});
 
-                if ((*iter).kind() == TokenKind::INTEGER) {
-                    state = ::State::LOAD_OP1_RPAREN;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required integer for ra register.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::LOAD_OP1_RPAREN, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_RPAREN});
+    setTransition(table, State::LOAD_OP1_RPAREN, TokenKind::RPAREN, {Action::SHIFT, State::LOAD_INST_EOL, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_OP1_RPAREN:
-                instruction.emplace_back(*iter);
+    // GROUP2: ra, unsigned integer
+    setTransition(table, State::LOAD_OP2_OPERAND, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_UINT});
+    setTransition(table, State::LOAD_OP2_OPERAND, TokenKind::INTEGER, {Action::UINT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_UINT});
+    setTransition(table, State::LOAD_OP2_OPERAND, TokenKind::STRING, {Action::UINT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_UINT});
 
-                if ((*iter).kind() == TokenKind::RPAREN) {
-                    state = ::State::LOAD_INST_EOL;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required a right parenthesis.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    // GROUP3: ra, signed integer
+    setTransition(table, State::LOAD_OP3_OPERAND, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_SINT});
+    setTransition(table, State::LOAD_OP3_OPERAND, TokenKind::INTEGER, {Action::SINT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_SINT});
+    setTransition(table, State::LOAD_OP3_OPERAND, TokenKind::STRING, {Action::SINT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_SINT});
+    setTransition(table, State::LOAD_OP3_OPERAND, TokenKind::SIGN, {Action::SINT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_SINT});
 
-                break;
-            case ::State::LOAD_OP2_OPERAND:
-                instruction.emplace_back(*iter);
-
-                if (::expectUInt(iter, tokens.end())) {
-                    state = ::State::LOAD_INST_EOL;
-                    if (::expectPrefix(iter, tokens.end())) {
-                        instruction.emplace_back(*(++iter));
-                        instruction.emplace_back(*(++iter));
-                    }
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required unsigned integer.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    // GROUP4: ra, signed integer(rb) or ra, (rb)
+    setTransition(table, State::LOAD_OP4_OPERAND, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_SINT_OR_LPAREN});
+    setTransition(table, State::LOAD_OP4_OPERAND, TokenKind::LPAREN, {Action::SHIFT, State::LOAD_OP4_RA, DiagnosticCode::NONE});
+    setTransition(table, State::LOAD_OP4_OPERAND, TokenKind::INTEGER, {Action::SINT, State::LOAD_OP4_LPAREN, DiagnosticCode::REQUIRED_SINT_OR_LPAREN});
+    setTransition(table, State::LOAD_OP4_OPERAND, TokenKind::STRING, {Action::SINT, State::LOAD_OP4_LPAREN, DiagnosticCode::REQUIRED_SINT_OR_LPAREN});
+    setTransition(table, State::LOAD_OP4_OPERAND, TokenKind::SIGN, {Action::SINT, State::LOAD_OP4_LPAREN, DiagnosticCode::REQUIRED_SINT_OR_LPAREN});
 
-                break;
-            case ::State::LOAD_OP3_OPERAND:
-                instruction.emplace_back(*iter);
+    setTransition(table, State::LOAD_OP4_LPAREN, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_LPAREN});
+    setTransition(table, State::LOAD_OP4_LPAREN, TokenKind::LPAREN, {Action::SHIFT, State::LOAD_OP4_RA, DiagnosticCode::NONE});
 
-                if (::expectSInt(iter, tokens.end())) {
-                    state = ::State::LOAD_INST_EOL;
-                    if ((*iter).kind() == TokenKind::SIGN) {
-                        instruction.emplace_back(*(++iter));
-                    }
-                    if (::expectPrefix(iter, tokens.end())) {
-                        instruction.emplace_back(*(++iter));
-                        instruction.emplace_back(*(++iter));
-                    }
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required signed integer.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::LOAD_OP4_RA, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_RA});
+    setTransition(table, State::LOAD_OP4_RA, TokenKind::INTEGER, {Action::RA, State::LOAD_OP4_RPAREN, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_OP4_OPERAND:
-                instruction.emplace_back(*iter);
-
-                if ((*iter).kind() == TokenKind::LPAREN) {
-                    state = ::State::LOAD_OP4_RA;
-                } else if (::expectSInt(iter, tokens.end())) {
-                    state = ::State::LOAD_OP4_LPAREN;
-                    if ((*iter).kind() == TokenKind::SIGN) {
-                        instruction.emplace_back(*(++iter));
-                    }
-                    if (::expectPrefix(iter, tokens.end())) {
-                        instruction.emplace_back(*(++iter));
-                        instruction.emplace_back(*(++iter));
-                    }
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required signed integer or a left parenthesis.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::LOAD_OP4_RPAREN, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_RPAREN});
+    setTransition(table, State::LOAD_OP4_RPAREN, TokenKind::RPAREN, {Action::SHIFT, State::LOAD_INST_EOL, DiagnosticCode::NONE});
 
-                break;
-            case ::State::LOAD_OP4_LPAREN:
-                instruction.emplace_back(*iter);
+    // GROUP5 and GROUP6: address
+    for (auto state : {State::LOAD_OP5_ADDRESS, State::LOAD_OP6_ADDRESS}) {
+        setTransition(table, state, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_ADDRESS});
+        setTransition(table, state, TokenKind::STAR, {Action::ADDRESS, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_ADDRESS});
+        setTransition(table, state, TokenKind::STRING, {Action::ADDRESS, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_ADDRESS});
+    }
 
-                if ((*iter).kind() == TokenKind::LPAREN) {
-                    state = ::State::LOAD_OP4_RA;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    instruction.emplace_back(*iter);
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required a left parenthesis.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    // GROUP7: device
+    setTransition(table, State::LOAD_OP7_DEVICE, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_DEVICE});
+    setTransition(table, State::LOAD_OP7_DEVICE, TokenKind::STRING, {Action::DEVICE, State::LOAD_INST_EOL, DiagnosticCode::UNKNOWN_DEVICE_NAME});
+    setTransition(table, State::LOAD_OP7_DEVICE, TokenKind::INTEGER, {Action::DEVICE, State::LOAD_INST_EOL, DiagnosticCode::UNKNOWN_DEVICE_NUMBER});
 
-                break;
-            case ::State::LOAD_OP4_RA:
-                instruction.emplace_back(*iter);
+    // GROUP9: DC, DS and ORG
+    setTransition(table, State::LOAD_DC_OPERAND, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_CONSTANT});
+    setTransition(table, State::LOAD_DC_OPERAND, TokenKind::INTEGER, {Action::CONSTANT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_CONSTANT});
+    setTransition(table, State::LOAD_DC_OPERAND, TokenKind::STRING, {Action::CONSTANT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_CONSTANT});
+    setTransition(table, State::LOAD_DC_OPERAND, TokenKind::SIGN, {Action::CONSTANT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_CONSTANT});
+    setTransition(table, State::LOAD_DC_OPERAND, TokenKind::CHARS, {Action::CONSTANT, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_CONSTANT});
 
-                if ((*iter).kind() == TokenKind::INTEGER) {
-                    state = ::State::LOAD_OP4_RPAREN;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required integer for ra register.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+    setTransition(table, State::LOAD_DS_OPERAND, {Action::DECIMAL, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_DECIMAL});
+    setTransition(table, State::LOAD_DS_OPERAND, TokenKind::EOL, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_DECIMAL});
+    setTransition(table, State::LOAD_ORG_OPERAND, {Action::HEXADECIMAL, State::LOAD_INST_EOL, DiagnosticCode::REQUIRED_HEXADECIMAL});
+    setTransition(table, State::LOAD_ORG_OPERAND, TokenKind::EOL, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::REQUIRED_HEXADECIMAL});
+
+    setTransition(table, State::LOAD_INST_EOL, {Action::REJECT, State::LOAD_LABEL, DiagnosticCode::TOO_MANY_TOKENS});
+    setTransition(table, State::LOAD_INST_EOL, TokenKind::EOL, {Action::EMIT, State::LOAD_LABEL, DiagnosticCode::NONE});
+
+    setTransition(table, State::LOAD_END_EOL, {Action::REJECT, State::FINAL, DiagnosticCode::TOO_MANY_TOKENS});
+    setTransition(table, State::LOAD_END_EOL, TokenKind::EOL, {Action::ACCEPT, State::FINAL, DiagnosticCode::NONE});
+
+    setTransition(table, State::FINAL, {Action::FINISH, State::FINAL, DiagnosticCode::NONE});
+
+    return table;
+}
+
+/**
+ * @brief Table of transitions of the parser
+ */
+constexpr TransitionTable TRANSITIONS = makeTransitionTable();
+
+/**
+ * @brief State after an opecode indexed by its group
+ *
+ * GROUP9 (DC, DS and ORG) and INVALID (END) are refined by the opecode.
+ */
+const State OPECODE_STATES[] = {
+    State::LOAD_RB,           // GROUP1
+    State::LOAD_RB,           // GROUP2
+    State::LOAD_RB,           // GROUP3
+    State::LOAD_RB,           // GROUP4
+    State::LOAD_RB,           // GROUP5
+    State::LOAD_OP6_ADDRESS,  // GROUP6
+    State::LOAD_OP7_DEVICE,   // GROUP7
+    State::LOAD_INST_EOL,     // GROUP8
+    State::LOAD_DC_OPERAND,   // GROUP9
+    State::LOAD_LABEL         // INVALID
+};
+
+/**
+ * @brief State after the comma of "rb," indexed by the group
+ */
+const State COMMA_STATES[] = {
+    State::LOAD_OP1_OPERAND,  // GROUP1
+    State::LOAD_OP2_OPERAND,  // GROUP2
+    State::LOAD_OP3_OPERAND,  // GROUP3
+    State::LOAD_OP4_OPERAND,  // GROUP4
+    State::LOAD_OP5_ADDRESS,  // GROUP5
+    State::LOAD_OP5_ADDRESS,  // GROUP6 (never)
+    State::LOAD_OP5_ADDRESS,  // GROUP7 (never)
+    State::LOAD_OP5_ADDRESS,  // GROUP8 (never)
+    State::LOAD_OP5_ADDRESS,  // GROUP9 (never)
+    State::LOAD_OP5_ADDRESS   // INVALID (never)
+};
+
+static_assert(sizeof(OPECODE_STATES) / sizeof(OPECODE_STATES[0]) == static_cast<size_t>(micro1::InstGroup::INVALID) + 1,
+              "OPECODE_STATES must have a state for each InstGroup");
+static_assert(sizeof(COMMA_STATES) / sizeof(COMMA_STATES[0]) == static_cast<size_t>(micro1::InstGroup::INVALID) + 1,
+              "COMMA_STATES must have a state for each InstGroup");
+
+}  // namespace
+
+namespace micro1 {
+
+/**
+ * @brief Parse lexical tokens
+ * @param[in] tokens tokens which parsed by lexical analyzer
+ * @param[out] diagnostics If not null, diagnostics of the erroneous rows are stored in it
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return std::vector<Row> parsed tokens
+ */
+Rows
+parse(const TokenStore& tokens, Diagnostics* diagnostics, Arena* arena, size_t error_limit) {
+    TokenStream stream(tokens);
+    return parse(stream, diagnostics, arena, error_limit);
+}
+
+/**
+ * @brief Tokenize and parse a source program at once
+ * @param[in] source a source program
+ * @param[out] diagnostics If not null, diagnostics of the erroneous rows are stored in it
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return std::vector<Row> parsed tokens
+ */
+Rows
+parse(const SourceBuffer& source, Diagnostics* diagnostics, Arena* arena, size_t error_limit) {
+    TokenStream stream(source);
+    return parse(stream, diagnostics, arena, error_limit);
+}
 
+/**
+ * @brief Parse lines of lexical tokens pulled from a stream
+ * @param[in] stream tokens which are tokenized on demand
+ * @param[in] first state at the first line (WAIT_TITLE or LOAD_LABEL)
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return ParsedLines parsed rows
+ */
+ParsedLines
+parseLines(TokenStream& stream, LineState first, Arena* arena, size_t error_limit) {
+    ParsedLines lines;
+    auto state = first == LineState::WAIT_TITLE ? ::State::WAIT_TITLE : ::State::LOAD_LABEL;
+    std::string_view label;
+    M1Addr addr = 0;
+    std::string_view reference;
+    int64_t offset = 0;
+    Rows& ret = lines.rows;
+    InstGroup group = InstGroup::INVALID;
+    // reused for every line and copied into each row (e.g. "LEA 2, -3(1)" has 8 tokens)
+    Tokens instruction;
+    instruction.reserve(8);
+    Operands operands;
+
+    while (!stream.eof()) {
+        const auto token = stream.peek();
+        const auto& transition = ::TRANSITIONS.entries[static_cast<size_t>(state)][static_cast<size_t>(token.kind())];
+        auto next = transition.next;
+        auto code = transition.code;
+        bool accepted = true;
+
+        switch (transition.action) {
+            case ::Action::SHIFT:
+                instruction.emplace_back(token.token());
+                break;
+            case ::Action::RB:
+                instruction.emplace_back(token.token());
+                operands.rb = static_cast<uint8_t>(::toNumber(token.str(), 10) & 0x3);
+                break;
+            case ::Action::RA:
+                instruction.emplace_back(token.token());
+                operands.ra = static_cast<uint8_t>(::toNumber(token.str(), 10) & 0x3);
                 break;
-            case ::State::LOAD_OP4_RPAREN:
-                instruction.emplace_back(*iter);
+            case ::Action::PASS:
+                break;
+            case ::Action::BLANK:
+                ret.emplace_back(Row("", addr, {}, ReferenceAddress("", 0, 0)));
+                break;
+            case ::Action::REJECT:
+                instruction.emplace_back(token.token());
+                accepted = false;
+                break;
+            case ::Action::ACCEPT:
+                ::flushRow(ret, label, addr, instruction, ReferenceAddress("", 0, 0), operands, arena);
+                break;
+            case ::Action::EMIT: {
+                const bool absolute = instruction.front().is(Keyword::ORG) || instruction.front().is(Keyword::DS);
+                const auto next_addr = absolute ? operands.value : static_cast<M1Addr>(addr + 1);
 
-                if ((*iter).kind() == TokenKind::RPAREN) {
-                    state = ::State::LOAD_INST_EOL;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required a right parenthesis.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+                ::flushRow(ret, label, addr, instruction, ReferenceAddress(reference, offset, 0), operands, arena);
+                addr = next_addr;
 
+                // addresses of the following rows don't depend on the preceding lines
+                if (absolute && !lines.absolute) {
+                    lines.absolute = true;
+                    lines.relative_rows = ret.size();
+                }
                 break;
-            case ::State::LOAD_OP5_ADDRESS:
-                instruction.emplace_back(*iter);
-                reference = (*iter).str();
-
-                if (::expectAddress(iter, tokens.end())) {
-                    state = ::State::LOAD_INST_EOL;
-                    if (iter + 1 < tokens.end()) {
-                        if ((*(iter + 1)).kind() == TokenKind::SIGN) {
-                            offset = static_cast<int64_t>(((*(iter + 1)).str() == "+" ? 1 : -1)) * std::stoi((*(iter + 2)).str());
-                            instruction.emplace_back(*(++iter));
-                            instruction.emplace_back(*(++iter));
-                        }
-                    }
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required address.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
+            }
+            case ::Action::TITLE:
+                instruction.emplace_back(token.token());
+                accepted = token.is(Keyword::TITLE);
+                break;
+            case ::Action::LABEL:
+                reference = std::string_view();
+                offset = 0;
+
+                if (!::expectColon(stream, 1)) {
+                    // the token is not a label but an opecode
+                    state = ::State::LOAD_OPECODE;
+                    label = std::string_view();
+                    continue;
                 }
-
+                label = token.str();
                 break;
-            case ::State::LOAD_OP6_ADDRESS:
-                instruction.emplace_back(*iter);
-                reference = (*iter).str();
-
-                if (::expectAddress(iter, tokens.end())) {
-                    state = ::State::LOAD_INST_EOL;
-                    if (iter + 1 < tokens.end()) {
-                        if ((*(iter + 1)).kind() == TokenKind::SIGN) {
-                            offset = static_cast<int64_t>(((*(iter + 1)).str() == "+" ? 1 : -1)) * std::stoi((*(iter + 2)).str());
-                            instruction.emplace_back(*(++iter));
-                            instruction.emplace_back(*(++iter));
-                        }
+            case ::Action::OPECODE: {
+                instruction.emplace_back(token.token());
+                const auto& inst = getInstInfo(token.id());
+                group = inst.group;
+                next = ::OPECODE_STATES[static_cast<size_t>(group)];
+
+                operands.opecode = token.id();
+                operands.group = group;
+                operands.op = inst.op;
+                operands.ra = inst.ra;
+                operands.rb = inst.rb;
+
+                if (group == InstGroup::GROUP9) {
+                    if (token.is(Keyword::DS)) {
+                        next = ::State::LOAD_DS_OPERAND;
+                    } else if (token.is(Keyword::ORG)) {
+                        next = ::State::LOAD_ORG_OPERAND;
                     }
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required address.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
+                } else if (group == InstGroup::INVALID) {
+                    accepted = token.is(Keyword::END);
+                    next = ::State::LOAD_END_EOL;
                 }
-
                 break;
-            case ::State::LOAD_OP7_DEVICE:
-                instruction.emplace_back(*iter);
-
-                if ((*iter).kind() == TokenKind::STRING) {
-                    if ((*iter).str() == "CR" || (*iter).str() == "LPT") {
-                        state = ::State::LOAD_INST_EOL;
-                    } else {
-                        state = ::State::LOAD_LABEL;
-                        ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Unknown device name.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                        instruction.clear();
-                        skipToEOL(iter, tokens.end());
-                    }
-                } else if ((*iter).kind() == TokenKind::INTEGER) {
-                    if ((*iter).str() == "0" || (*iter).str() == "1") {
-                        state = ::State::LOAD_INST_EOL;
+            }
+            case ::Action::COMMA:
+                instruction.emplace_back(token.token());
+                next = ::COMMA_STATES[static_cast<size_t>(group)];
+                break;
+            case ::Action::UINT:
+                instruction.emplace_back(token.token());
+                accepted = ::expectUInt(stream, 0);
+                if (accepted) {
+                    operands.value = ::readUInt(stream, 0);
+                    ::takeNumber(stream, instruction);
+                }
+                break;
+            case ::Action::SINT:
+                instruction.emplace_back(token.token());
+                accepted = ::expectSInt(stream, 0);
+                if (accepted) {
+                    operands.value = ::readSInt(stream, 0);
+                    ::takeNumber(stream, instruction);
+                }
+                break;
+            case ::Action::ADDRESS:
+                instruction.emplace_back(token.token());
+                reference = token.str();
+                accepted = ::expectAddress(stream, 0);
+
+                if (accepted && stream.peek(1) && stream.peek(1).kind() == TokenKind::SIGN) {
+                    const bool negative = stream.peek(1).str() == "-";
+                    if (::toOffset(stream.peek(2).str(), offset)) {
+                        offset = negative ? -offset : offset;
                     } else {
-                        state = ::State::LOAD_LABEL;
-                        ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Unknown device number.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                        instruction.clear();
-                        skipToEOL(iter, tokens.end());
+                        accepted = false;
+                        code = DiagnosticCode::OFFSET_OUT_OF_RANGE;
                     }
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required device name or number.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
+                    instruction.emplace_back(::advance(stream));
+                    instruction.emplace_back(::advance(stream));
                 }
-
                 break;
-            case ::State::LOAD_DC_OPERAND:
-                instruction.emplace_back(*iter);
-
-                if (::expectConstant(iter, tokens.end())) {
-                    state = ::State::LOAD_INST_EOL;
-                    if (::expectSInt(iter, tokens.end())) {
-                        if ((*iter).kind() == TokenKind::SIGN) {
-                            instruction.emplace_back(*(++iter));
-                        }
-                        if (::expectPrefix(iter, tokens.end())) {
-                            instruction.emplace_back(*(++iter));
-                            instruction.emplace_back(*(++iter));
-                        }
-                    }
+            case ::Action::DEVICE:
+                instruction.emplace_back(token.token());
+                if (token.kind() == TokenKind::STRING) {
+                    accepted = token.is(Keyword::CR) || token.is(Keyword::LPT);
+                    operands.value = token.is(Keyword::LPT) ? 1 : 0;
                 } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required constant value.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
+                    accepted = token.str() == "0" || token.str() == "1";
+                    operands.value = token.str() == "1" ? 1 : 0;
                 }
-
                 break;
-            case ::State::LOAD_DS_OPERAND:
-                instruction.emplace_back(*iter);
-
-                if (::isDecimal((*iter).str())) {
-                    state = ::State::LOAD_INST_EOL;
+            case ::Action::CONSTANT:
+                instruction.emplace_back(token.token());
+                accepted = ::expectConstant(stream, 0);
+                if (accepted && ::expectSInt(stream, 0)) {
+                    operands.value = ::readSInt(stream, 0);
+                    ::takeNumber(stream, instruction);
+                } else if (token.kind() == TokenKind::CHARS) {
+                    // two characters are packed in a word
+                    operands.value = static_cast<M1Word>((static_cast<uint8_t>(token.str()[1]) << 8) | static_cast<uint8_t>(token.str()[2]));
                 } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required decimal.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
+                    operands.label = token.id();
                 }
-
                 break;
-            case ::State::LOAD_ORG_OPERAND:
-                instruction.emplace_back(*iter);
+            case ::Action::DECIMAL:
+                instruction.emplace_back(token.token());
+                accepted = ::isDecimal(token.str());
+                operands.value = static_cast<M1Word>(::toNumber(token.str(), 10));
+                break;
+            case ::Action::HEXADECIMAL:
+                instruction.emplace_back(token.token());
+                accepted = ::isHexadecimal(token.str());
+                operands.value = static_cast<M1Word>(::toNumber(token.str(), 16));
+                break;
+            case ::Action::FINISH:
+                instruction.emplace_back(token.token());
+                goto EndOfParse;
+        }
 
-                if (::isHexadecimal((*iter).str())) {
-                    state = ::State::LOAD_INST_EOL;
-                } else {
-                    state = ::State::LOAD_LABEL;
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Required hexadecimal.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    instruction.clear();
-                    skipToEOL(iter, tokens.end());
-                }
+        if (!accepted) {
+            if (transition.action != ::Action::REJECT)
+                next = ::State::LOAD_LABEL;
 
+            lines.diagnostics.push_back({ret.size(), static_cast<uint32_t>(instruction.size() - 1), code});
+            ::flushRow(ret, label, addr, instruction, ReferenceAddress("", 0, 0), operands, arena);
+            if (error_limit != 0 && lines.diagnostics.size() >= error_limit) {
+                lines.stopped = true;
                 break;
-            case ::State::LOAD_INST_EOL:
-                state = ::State::LOAD_LABEL;
+            }
+            ::skipToEOL(stream);
+        }
 
-                if ((*iter).kind() == TokenKind::EOL) {
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::INFO, "", 0), ReferenceAddress(reference, offset, 0)));
+        // a label belongs to its own line
+        state = next;
+        if (state == ::State::LOAD_LABEL)
+            label = std::string_view();
 
-                    if ((*(iter - 2)).str() == "ORG") {
-                        addr = static_cast<M1Addr>(std::stoi((*(iter - 1)).str(), nullptr, 16));
-                    } else if ((*(iter - 2)).str() == "DS") {
-                        addr = static_cast<M1Addr>(std::stoi((*(iter - 1)).str(), nullptr, 10));
-                    } else {
-                        addr++;
-                    }
-                } else {
-                    instruction.emplace_back(*iter);
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Too many tokens.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    skipToEOL(iter, tokens.end());
-                }
+        stream.next();
+    }
 
-                instruction.clear();
-                break;
-            case ::State::LOAD_END_EOL:
-                state = ::State::FINAL;
+EndOfParse:
 
-                if ((*iter).kind() == TokenKind::EOL) {
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::INFO, "", 0), ReferenceAddress("", 0, 0)));
-                } else {
-                    instruction.emplace_back(*iter);
-                    ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Too many tokens.", instruction.size() - 1), ReferenceAddress("", 0, 0)));
-                    skipToEOL(iter, tokens.end());
-                }
+    for (; !lines.stopped && !stream.eof(); stream.next()) {
+        if (stream.peek().kind() == TokenKind::EOL) {
+            lines.diagnostics.push_back({ret.size(), 0, DiagnosticCode::INVALID_TOKEN});
+            ret.emplace_back(Row(label, addr, ::copyTokens(instruction, arena), ReferenceAddress("", 0, 0)));
+            lines.stopped = error_limit != 0 && lines.diagnostics.size() >= error_limit;
+        } else {
+            instruction.emplace_back(stream.peek().token());
+        }
+    }
 
-                instruction.clear();
-                break;
-            case ::State::FINAL:
-                instruction.emplace_back(*iter);
-                goto EndOfParse;
-            default:
-                std::cerr << "Detected invalid state of parser." << std::endl;
-                exit(2);
+    if (!lines.stopped && instruction.size() != 0) {
+        lines.diagnostics.push_back({ret.size(), 0, DiagnosticCode::INVALID_TOKEN});
+        ret.emplace_back(Row(label, addr, ::copyTokens(instruction, arena), ReferenceAddress("", 0, 0)));
+    }
+
+    // a line leaves the parser in another state only after END or an operand which is missing
+    if (state == ::State::WAIT_TITLE || state == ::State::LOAD_LABEL) {
+        lines.state = state == ::State::WAIT_TITLE ? LineState::WAIT_TITLE : LineState::LOAD_LABEL;
+    } else {
+        lines.state = LineState::FINISHED;
+    }
+    lines.addr = addr;
+    if (!lines.absolute)
+        lines.relative_rows = ret.size();
+
+    return lines;
+}
+
+/**
+ * @brief Parse lexical tokens pulled from a stream
+ * @param[in] stream tokens which are tokenized on demand
+ * @param[out] diagnostics If not null, diagnostics of the erroneous rows are stored in it
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return std::vector<Row> parsed tokens
+ */
+Rows
+parse(TokenStream& stream, Diagnostics* diagnostics, Arena* arena, size_t error_limit) {
+    auto lines = parseLines(stream, LineState::WAIT_TITLE, arena, error_limit);
+    if (diagnostics)
+        *diagnostics = std::move(lines.diagnostics);
+
+    return std::move(lines.rows);
+}
+
+/**
+ * @brief Tokenize and parse a source program in parallel
+ *
+ * Phase 1 parses chunks of lines independently from address 0. Each chunk
+ * starts at LOAD_LABEL because every line but the ones before TITLE and
+ * after END ends there. Phase 2 scans the chunks for their start addresses:
+ * a chunk adds its number of words, or sets the address by ORG or DS.
+ * Phase 3 moves the relative addresses by them, and moves ids of
+ * identifiers into one interner in the order of the first appearance, as
+ * the sequential parser does.
+ * If a chunk doesn't end at LOAD_LABEL (e.g. END before the last chunk),
+ * the source program is parsed sequentially instead.
+ *
+ * @param[in] source a source program
+ * @param[in] pool threads which parse chunks of the source program
+ * @param[out] diagnostics If not null, diagnostics of the erroneous rows are stored in it
+ * @param[in] arena If not null, tokens of the rows are allocated from it
+ * @param[in] error_limit parsing stops at the row with this number of errors (0: no limit)
+ * @return std::vector<Row> parsed tokens (same as parse(source))
+ */
+Rows
+parse(const SourceBuffer& source, ThreadPool& pool, Diagnostics* diagnostics, Arena* arena, size_t error_limit) {
+    const auto chunks = splitSource(source.data(), pool);
+    if (chunks.size() == 1)
+        return parse(source, diagnostics, arena, error_limit);
+
+    // an arena isn't thread-safe, so each chunk has its own
+    std::vector<Arena*> arenas(chunks.size(), nullptr);
+    if (arena) {
+        for (auto& chunk_arena : arenas) {
+            chunk_arena = &arena->child();
         }
     }
 
-EndOfParse:
+    std::vector<ParsedLines> parsed(chunks.size());
+    std::vector<Interner> interners(chunks.size());
+    pool.run(chunks.size(), [&chunks, &arenas, &parsed, &interners, error_limit](size_t i) {
+        TokenStream stream(chunks[i].data, chunks[i].first_row);
+        parsed[i] = parseLines(stream, i == 0 ? LineState::WAIT_TITLE : LineState::LOAD_LABEL, arenas[i], error_limit);
+        interners[i] = stream.interner();
+    });
+
+    // the rows after a chunk which is stopped by the error limit are dropped
+    for (size_t i = 0; i + 1 < parsed.size() && !parsed[i].stopped; i++) {
+        if (parsed[i].state != LineState::LOAD_LABEL)
+            return parse(source, diagnostics, arena, error_limit);
+    }
 
-    for (; iter < tokens.end(); iter++) {
-        if ((*iter).kind() == TokenKind::EOL) {
-            ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Invalid token.", 0), ReferenceAddress("", 0, 0)));
-            skipToEOL(iter, tokens.end());
-        } else {
-            instruction.emplace_back(*iter);
+    // start addresses of the chunks
+    std::vector<M1Addr> bases(chunks.size(), 0);
+    for (size_t i = 1; i < chunks.size(); i++) {
+        const auto& prev = parsed[i - 1];
+        bases[i] = prev.absolute ? prev.addr : static_cast<M1Addr>(bases[i - 1] + prev.addr);
+    }
+
+    // new ids of identifiers of the chunks
+    Interner interner;
+    std::vector<std::vector<SymbolId>> ids(chunks.size());
+    for (size_t i = 0; i < chunks.size(); i++) {
+        ids[i].resize(interners[i].size());
+        for (SymbolId id = 0; id < interners[i].size(); id++) {
+            ids[i][id] = interner.intern(interners[i].str(id));
         }
     }
 
-    if (instruction.size() != 0) {
-        ret.emplace_back(Row(label, addr, instruction, DebugInfo(DebugInfoImportance::ERROR, "Invalid token.", 0), ReferenceAddress("", 0, 0)));
-        skipToEOL(iter, tokens.end());
+    pool.run(chunks.size(), [&parsed, &bases, &ids](size_t i) {
+        auto& rows = parsed[i].rows;
+        for (size_t j = 0; j < parsed[i].relative_rows; j++) {
+            rows[j].addr(static_cast<M1Addr>(bases[i] + rows[j].addr()));
+        }
+        if (i > 0) {
+            for (auto& row : rows) {
+                row.remap(ids[i]);
+            }
+        }
+    });
+
+    size_t size = 0;
+    for (const auto& lines : parsed) {
+        size += lines.rows.size();
+    }
+
+    Rows ret;
+    ret.reserve(size);
+    if (diagnostics)
+        diagnostics->clear();
+    size_t errors = 0;
+    for (auto& lines : parsed) {
+        // rows end at the error which reaches the limit, as the sequential parser stops there
+        size_t end = lines.rows.size();
+        bool stopped = false;
+        for (auto diagnostic : lines.diagnostics) {
+            if (diagnostics)
+                diagnostics->push_back({ret.size() + diagnostic.row, diagnostic.index, diagnostic.code});
+            if (error_limit != 0 && ++errors >= error_limit) {
+                end = diagnostic.row + 1;
+                stopped = true;
+                break;
+            }
+        }
+
+        std::move(lines.rows.begin(), lines.rows.begin() + static_cast<std::ptrdiff_t>(end), std::back_inserter(ret));
+        if (stopped)
+            break;
     }
 
     return ret;
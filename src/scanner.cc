@@ -0,0 +1,202 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file scanner.cc
+ * @brief Implementation for scanning runs of characters in source program
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/scanner.h"
+
+#include "micro1-as/charclass.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MICRO1_HAS_SSE2
+#endif
+
+#if defined(MICRO1_HAS_SSE2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+bool
+isBlank(unsigned char c) {
+    return micro1::CHAR_TABLE.flags[c] & micro1::CHAR_BLANK;
+}
+
+bool
+isAlnum(unsigned char c) {
+    return micro1::CHAR_TABLE.flags[c] & micro1::CHAR_ALNUM;
+}
+
+bool
+isXDigit(unsigned char c) {
+    return micro1::CHAR_TABLE.flags[c] & micro1::CHAR_XDIGIT;
+}
+
+#ifdef MICRO1_HAS_SSE2
+
+const std::ptrdiff_t VECTOR_SIZE = 16;
+
+unsigned
+countTrailingZeros(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * @brief Mask of bytes in [lo, hi]
+ *
+ * Bytes over 0x7F are negative as signed chars, so they are never in [lo, hi].
+ */
+__m128i
+inRange(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+__m128i
+blankMask(__m128i v) {
+    // ' ' or '\t', '\v', '\f', '\r' (but not '\n')
+    return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                        _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), inRange(v, '\t', '\r')));
+}
+
+__m128i
+alnumMask(__m128i v) {
+    auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    return _mm_or_si128(inRange(v, '0', '9'), inRange(lower, 'a', 'z'));
+}
+
+__m128i
+xdigitMask(__m128i v) {
+    auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    return _mm_or_si128(inRange(v, '0', '9'), inRange(lower, 'a', 'f'));
+}
+
+#endif
+
+/**
+ * @brief Skip characters which belong to a class
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @param[in] mask classifier for 16 characters
+ * @param[in] pred classifier for a character
+ * @return const char* first character out of the class, or tail
+ */
+template <typename Mask, typename Pred>
+const char*
+skip(const char* head, const char* tail, [[maybe_unused]] Mask mask, Pred pred) {
+#ifdef MICRO1_HAS_SSE2
+    while (tail - head >= VECTOR_SIZE) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(head));
+        auto bits = static_cast<unsigned>(_mm_movemask_epi8(mask(v))) ^ 0xFFFFu;
+        if (bits != 0)
+            return head + countTrailingZeros(bits);
+        head += VECTOR_SIZE;
+    }
+#endif
+
+    while (head < tail && pred(static_cast<unsigned char>(*head)))
+        head++;
+
+    return head;
+}
+
+}  // namespace
+
+namespace micro1 {
+
+/**
+ * @brief Skip blanks (whitespaces except a new line)
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @return const char* first character which is not blank, or tail
+ */
+const char*
+skipBlanks(const char* head, const char* tail) {
+#ifdef MICRO1_HAS_SSE2
+    return ::skip(head, tail, ::blankMask, ::isBlank);
+#else
+    return ::skip(head, tail, nullptr, ::isBlank);
+#endif
+}
+
+/**
+ * @brief Skip alphabets and digits ([A-Za-z0-9])
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @return const char* first character which is not alphabet or digit, or tail
+ */
+const char*
+skipAlnums(const char* head, const char* tail) {
+#ifdef MICRO1_HAS_SSE2
+    return ::skip(head, tail, ::alnumMask, ::isAlnum);
+#else
+    return ::skip(head, tail, nullptr, ::isAlnum);
+#endif
+}
+
+/**
+ * @brief Skip hexadecimal digits ([A-Fa-f0-9])
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @return const char* first character which is not hexadecimal digit, or tail
+ */
+const char*
+skipXDigits(const char* head, const char* tail) {
+#ifdef MICRO1_HAS_SSE2
+    return ::skip(head, tail, ::xdigitMask, ::isXDigit);
+#else
+    return ::skip(head, tail, nullptr, ::isXDigit);
+#endif
+}
+
+/**
+ * @brief Find a new line
+ *
+ * memchr() of the C library is vectorized with the widest instruction set
+ * which the CPU supports, so it is used as it is.
+ *
+ * @param[in] head first character to be scanned
+ * @param[in] tail end of the source program
+ * @return const char* the new line, or tail
+ */
+const char*
+findEOL(const char* head, const char* tail) {
+    if (head >= tail)
+        return tail;
+
+    auto eol = static_cast<const char*>(std::memchr(head, '\n', static_cast<size_t>(tail - head)));
+    return eol ? eol : tail;
+}
+
+}  // namespace micro1
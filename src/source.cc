@@ -0,0 +1,173 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file source.cc
+ * @brief Implementation for buffer of source program
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/source.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MICRO1_HAS_MMAP
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace micro1 {
+
+/**
+ * @brief Constructor for SourceBuffer
+ * @param[in] is a source program
+ */
+SourceBuffer::SourceBuffer(std::istream& is) : m_mapped(nullptr), m_mapped_size(0) {
+    read(is);
+}
+
+/**
+ * @brief Load a source program from a stream
+ * @param[in] is a source program (e.g. std::cin)
+ * @return bool If true, the stream is read successfully
+ */
+bool
+SourceBuffer::read(std::istream& is) {
+    unmap();
+    m_data.clear();
+    m_line_starts.clear();
+
+    std::string line;
+    while (std::getline(is, line)) {
+        m_data += line;
+        m_data += '\n';
+    }
+
+    return !is.bad();
+}
+
+/**
+ * @brief Destructor for SourceBuffer
+ */
+SourceBuffer::~SourceBuffer() {
+    unmap();
+}
+
+/**
+ * @brief Load a source program from a file
+ * @param[in] filename a file name of source program
+ * @return bool If true, the file is loaded successfully
+ */
+bool
+SourceBuffer::open(const std::string& filename) {
+    unmap();
+    m_data.clear();
+    m_line_starts.clear();
+
+#ifdef MICRO1_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            ::close(fd);
+            m_mapped = static_cast<const char*>(addr);
+            m_mapped_size = static_cast<size_t>(st.st_size);
+            return true;
+        }
+    }
+
+    // pipes and the like can't be mapped, so they are read at once
+    char buffer[1 << 16];
+    for (;;) {
+        auto n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0) {
+            ::close(fd);
+            m_data.clear();
+            return false;
+        }
+        if (n == 0)
+            break;
+        m_data.append(buffer, static_cast<size_t>(n));
+    }
+
+    ::close(fd);
+    return true;
+#else
+    std::ifstream ifs(filename);
+    if (ifs.fail())
+        return false;
+
+    m_data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    return true;
+#endif
+}
+
+/**
+ * @brief Return a line of the source program
+ * @param[in] row row number (1-origin)
+ * @return std::string_view the line without the new line, or empty if row is out of range
+ */
+std::string_view
+SourceBuffer::line(uint64_t row) const {
+    const auto bytes = data();
+
+    if (m_line_starts.empty()) {
+        m_line_starts.push_back(0);
+        for (auto eol = bytes.find('\n'); eol != std::string_view::npos; eol = bytes.find('\n', eol + 1))
+            m_line_starts.push_back(eol + 1);
+    }
+
+    if (row == 0 || row > m_line_starts.size())
+        return std::string_view();
+
+    const auto head = m_line_starts[row - 1];
+    const auto tail = row < m_line_starts.size() ? m_line_starts[row] - 1 : bytes.size();
+    return bytes.substr(head, tail - head);
+}
+
+/**
+ * @brief Release the mapped file
+ */
+void
+SourceBuffer::unmap() {
+#ifdef MICRO1_HAS_MMAP
+    if (m_mapped)
+        ::munmap(const_cast<char*>(m_mapped), m_mapped_size);
+#endif
+    m_mapped = nullptr;
+    m_mapped_size = 0;
+}
+
+}  // namespace micro1
@@ -27,38 +27,269 @@
 
 #include "micro1-as/symbol.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Return hash of a label
+ * @param[in] label label name
+ * @return uint32_t hash of the label
+ */
+uint32_t
+hashLabel(std::string_view label) {
+    return static_cast<uint32_t>(std::hash<std::string_view>()(label));
+}
+
+/**
+ * @brief Minimum number of rows of a chunk which is resolved in parallel
+ */
+const size_t MIN_CHUNK_ROWS = 16 * 1024;
+
+/**
+ * @brief Resolve references of a range of rows
+ * @param[in,out] rows parsed rows whose references are resolved in place
+ * @param[in] begin index of the first row
+ * @param[in] end index after the last row
+ * @param[in] symbol_table labels of the rows
+ * @param[out] references If not null, pairs of the index of a symbol and the index of a row which refers to it are appended
+ */
+void
+resolveRange(micro1::Rows& rows, size_t begin, size_t end, const micro1::SymbolTable& symbol_table, std::vector<std::pair<size_t, size_t>>* references) {
+    for (size_t i = begin; i < end; i++) {
+        auto& row = rows[i];
+        const auto& raddr = row.raddr();
+        if (raddr.label() == "*") {
+            row.resolve(static_cast<micro1::M1Addr>(raddr.offset()));
+        } else if (auto symbol = raddr.label().empty() ? nullptr : symbol_table.find(raddr.label()); symbol != nullptr) {
+            row.resolve(static_cast<micro1::M1Addr>(symbol->addr - row.addr() + raddr.offset()));
+
+            if (references != nullptr)
+                references->emplace_back(symbol_table.index(*symbol), i);
+        } else if (references != nullptr && row.operands().label != micro1::NO_SYMBOL) {
+            // DC of a label
+            if (auto symbol = symbol_table.find(row.instruction().at(1).str()); symbol != nullptr)
+                references->emplace_back(symbol_table.index(*symbol), i);
+        }
+    }
+}
+
+}  // namespace
+
 namespace micro1 {
 
-std::map<std::string, micro1::M1Addr>
-generateSymbolTable(Rows rows) {
-    std::map<std::string, micro1::M1Addr> symbol_table;
+/**
+ * @brief Insert a label unless it is already in the table
+ * @param[in] label label name
+ * @param[in] addr address of the label
+ * @param[in] row index of the row which defines the label
+ * @return std::pair<Symbol*, bool> the symbol of the label (valid until the next insert), and false if it is already in the table and kept
+ */
+std::pair<Symbol*, bool>
+SymbolTable::insert(std::string_view label, M1Addr addr, size_t row) {
+    // keep the load factor at most 1/2
+    if ((m_symbols.size() + 1) * 2 > m_slots.size())
+        grow();
 
-    for (auto row : rows) {
-        if (row.label() != "")
-            symbol_table.insert(std::make_pair(row.label(), row.addr()));
+    const uint32_t hash = ::hashLabel(label);
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        auto& slot = m_slots[i];
+        if (slot.index == 0) {
+            m_symbols.push_back({label, addr, row, false});
+            slot = {hash, static_cast<uint32_t>(m_symbols.size())};
+            return {&m_symbols.back(), true};
+        }
+        if (slot.hash == hash && m_symbols[slot.index - 1].label == label)
+            return {&m_symbols[slot.index - 1], false};
     }
+}
 
-    return symbol_table;
+/**
+ * @brief Find a label
+ * @param[in] label label name
+ * @return const Symbol* the symbol of the label, or nullptr if it isn't in the table
+ */
+const Symbol*
+SymbolTable::find(std::string_view label) const {
+    if (m_slots.empty())
+        return nullptr;
+
+    const uint32_t hash = ::hashLabel(label);
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const auto& slot = m_slots[i];
+        if (slot.index == 0)
+            return nullptr;
+        if (slot.hash == hash && m_symbols[slot.index - 1].label == label)
+            return &m_symbols[slot.index - 1];
+    }
 }
 
-Rows
-resolveSymbols(Rows rows) {
-    auto symbol_table = generateSymbolTable(rows);
+/**
+ * @brief Return indices of symbols in order of labels
+ * @return std::vector<size_t> indices of symbols which are sorted by their labels
+ */
+std::vector<size_t>
+SymbolTable::order() const {
+    std::vector<size_t> indices(m_symbols.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(), [this](size_t a, size_t b) { return m_symbols[a].label < m_symbols[b].label; });
 
-    for (auto & row : rows) {
-        if (row.raddr().label() == "*") {
-            auto r = row.raddr();
-            r.val(r.offset());
-            row.raddr(r);
-        }
-        else if (symbol_table.find(row.raddr().label()) != symbol_table.end()) {
-            auto r = row.raddr();
-            r.val(symbol_table.at(row.raddr().label()) - row.addr() + r.offset());
-            row.raddr(r);
+    return indices;
+}
+
+/**
+ * @brief Return symbols in order of labels
+ * @return std::vector<Symbol> symbols which are sorted by their labels
+ */
+std::vector<Symbol>
+SymbolTable::sorted() const {
+    auto symbols = m_symbols;
+    std::sort(symbols.begin(), symbols.end(), [](const Symbol& a, const Symbol& b) { return a.label < b.label; });
+
+    return symbols;
+}
+
+/**
+ * @brief Remove all symbols
+ */
+void
+SymbolTable::clear() {
+    m_symbols.clear();
+    m_slots.clear();
+}
+
+/**
+ * @brief Double the number of slots and insert the symbols into them again
+ */
+void
+SymbolTable::grow() {
+    std::vector<Slot> slots(std::max<size_t>(16, m_slots.size() * 2), Slot{0, 0});
+    const size_t mask = slots.size() - 1;
+
+    for (const auto& slot : m_slots) {
+        if (slot.index == 0)
+            continue;
+
+        size_t i = slot.hash & mask;
+        while (slots[i].index != 0)
+            i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+
+    m_slots = std::move(slots);
+}
+
+/**
+ * @brief Build the index from references
+ *
+ * References are placed by counting sort, which keeps the order of rows in
+ * each symbol.
+ *
+ * @param[in] symbols number of symbols
+ * @param[in] references pairs of the index of a symbol and the index of a row which refers to it, in order of rows
+ */
+void
+CrossReference::assign(size_t symbols, const std::vector<std::pair<size_t, size_t>>& references) {
+    m_offsets.assign(symbols + 1, 0);
+    m_rows.resize(references.size());
+
+    for (const auto& reference : references)
+        m_offsets[reference.first + 1]++;
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+    // m_offsets[symbol] is the next place of the symbol while references are placed
+    for (const auto& [symbol, row] : references)
+        m_rows[m_offsets[symbol]++] = row;
+    std::copy_backward(m_offsets.begin(), m_offsets.end() - 1, m_offsets.end());
+    m_offsets[0] = 0;
+}
+
+/**
+ * @brief Return rows which refer to a symbol
+ * @param[in] symbol index of the symbol in the symbol table
+ * @return Range indices of the rows in order (empty if symbol is out of range)
+ */
+CrossReference::Range
+CrossReference::references(size_t symbol) const {
+    if (symbol >= size())
+        return {nullptr, nullptr};
+
+    return {m_rows.data() + m_offsets[symbol], m_rows.data() + m_offsets[symbol + 1]};
+}
+
+/**
+ * @brief Remove all references
+ */
+void
+CrossReference::clear() {
+    m_offsets.clear();
+    m_rows.clear();
+}
+
+SymbolTable
+generateSymbolTable(const Rows& rows, Diagnostics* diagnostics) {
+    SymbolTable symbol_table;
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        const auto& row = rows[i];
+        if (row.label() == "")
+            continue;
+
+        auto [symbol, inserted] = symbol_table.insert(row.label(), row.addr(), i);
+        if (inserted || diagnostics == nullptr)
+            continue;
+
+        if (!symbol->duplicate) {
+            symbol->duplicate = true;
+            diagnostics->push_back({symbol->row, 0, DiagnosticCode::PREVIOUS_LABEL});
         }
+        diagnostics->push_back({i, 0, DiagnosticCode::DUPLICATE_LABEL});
     }
 
-    return rows;
+    return symbol_table;
+}
+
+void
+resolveSymbols(Rows& rows, const SymbolTable& symbol_table, CrossReference* cross_reference) {
+    std::vector<std::pair<size_t, size_t>> references;
+    ::resolveRange(rows, 0, rows.size(), symbol_table, cross_reference != nullptr ? &references : nullptr);
+
+    if (cross_reference != nullptr)
+        cross_reference->assign(symbol_table.size(), references);
+}
+
+void
+resolveSymbols(Rows& rows, const SymbolTable& symbol_table, ThreadPool& pool, CrossReference* cross_reference) {
+    const size_t chunks = std::min<size_t>(pool.size() * 4, rows.size() / ::MIN_CHUNK_ROWS);
+    if (chunks <= 1) {
+        resolveSymbols(rows, symbol_table, cross_reference);
+        return;
+    }
+
+    // each chunk collects its references, which are joined in order of the chunks
+    std::vector<std::vector<std::pair<size_t, size_t>>> references(chunks);
+    pool.run(chunks, [&rows, &symbol_table, &references, cross_reference, chunks](size_t i) {
+        const size_t begin = rows.size() * i / chunks;
+        const size_t end = rows.size() * (i + 1) / chunks;
+        ::resolveRange(rows, begin, end, symbol_table, cross_reference != nullptr ? &references[i] : nullptr);
+    });
+
+    if (cross_reference != nullptr) {
+        size_t size = 0;
+        for (const auto& chunk : references)
+            size += chunk.size();
+
+        auto& joined = references[0];
+        joined.reserve(size);
+        for (size_t i = 1; i < chunks; i++)
+            joined.insert(joined.end(), references[i].begin(), references[i].end());
+        cross_reference->assign(symbol_table.size(), joined);
+    }
 }
 
 }  // namespace micro1
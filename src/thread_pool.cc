@@ -0,0 +1,151 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file thread_pool.cc
+ * @brief Implementation for pool of worker threads
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/thread_pool.h"
+
+namespace micro1 {
+
+/**
+ * @brief Constructor for ThreadPool
+ *
+ * The caller of run() is one of the threads, so threads - 1 workers are
+ * created. They wait for run() until the pool is destroyed.
+ *
+ * @param[in] threads number of threads including the caller (0: number of cores)
+ */
+ThreadPool::ThreadPool(unsigned threads)
+    : m_task(nullptr), m_count(0), m_next(0), m_finished(0), m_generation(0), m_stop(false) {
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+
+    for (unsigned i = 1; i < threads; i++) {
+        m_workers.emplace_back([this]() { work(); });
+    }
+}
+
+/**
+ * @brief Destructor for ThreadPool
+ *
+ * The workers are stopped and joined. It must not be called while run() is
+ * running.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Run task(0), ..., task(count - 1) and wait for all of them
+ *
+ * The caller takes tasks like the workers, so it returns only after every
+ * task has finished. Tasks run in any order and on any thread.
+ * Tasks must not throw exceptions, because nothing catches them on the
+ * workers. Calls don't nest: a task must not call run() of the same pool,
+ * and only one thread may call run() at a time.
+ *
+ * @param[in] count number of tasks
+ * @param[in] task a task which takes its index
+ */
+void
+ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0)
+        return;
+
+    if (m_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next = 0;
+    m_finished = 0;
+    m_generation++;
+    m_wake.notify_all();
+
+    while (runNext(lock)) {
+    }
+    m_done.wait(lock, [this]() { return m_finished == m_count; });
+    m_task = nullptr;
+}
+
+/**
+ * @brief Run the next task of the current run if it remains
+ * @param[in] lock lock of m_mutex, which is released while the task runs
+ * @return bool If false, no task remains
+ */
+bool
+ThreadPool::runNext(std::unique_lock<std::mutex>& lock) {
+    if (m_task == nullptr || m_next >= m_count)
+        return false;
+
+    const auto& task = *m_task;
+    size_t index = m_next++;
+
+    lock.unlock();
+    task(index);
+    lock.lock();
+
+    if (++m_finished == m_count)
+        m_done.notify_all();
+
+    return true;
+}
+
+/**
+ * @brief Main loop of a worker thread
+ */
+void
+ThreadPool::work() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t generation = 0;
+
+    while (true) {
+        m_wake.wait(lock, [this, &generation]() { return m_stop || m_generation != generation; });
+        if (m_stop)
+            return;
+
+        generation = m_generation;
+        while (runNext(lock)) {
+        }
+    }
+}
+
+}  // namespace micro1
@@ -0,0 +1,213 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file token.cc
+ * @brief Implementation for compact store of tokens
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/token.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace micro1 {
+
+/**
+ * @brief Remove all tokens and lines (the memory and the interner are kept)
+ * @param[in] base head of the bytes which tokens refer to
+ * @param[in] first_row row number of the first line
+ */
+void
+TokenStore::clear(const char* base, uint64_t first_row) {
+    m_base = base;
+    m_first_row = first_row;
+    m_kinds.clear();
+    m_offsets.clear();
+    m_lengths.clear();
+    m_line_indices.clear();
+    m_ids.clear();
+    m_line_starts.clear();
+    m_long_lengths.clear();
+}
+
+/**
+ * @brief Start a new line
+ *
+ * The end of the line is checked first, so that offsets of all tokens on
+ * the line fit in 32 bits.
+ *
+ * @param[in] line a line without the new line
+ */
+void
+TokenStore::addLine(std::string_view line) {
+    offset(line.data() + line.size());
+    m_line_starts.push_back(offset(line.data()));
+}
+
+/**
+ * @brief Add a token on the last line
+ *
+ * A STRING token is interned. A token which is longer than LONG_LENGTH
+ * keeps its length in m_long_lengths.
+ *
+ * @param[in] kind token kind
+ * @param[in] column column number
+ * @param[in] size size of string
+ */
+void
+TokenStore::add(TokenKind kind, uint64_t column, size_t size) {
+    const auto line = m_line_starts.back();
+
+    if (size >= LONG_LENGTH) {
+        if (size > UINT32_MAX)
+            throw std::length_error("TokenStore: too long token");
+        m_long_lengths.emplace_back(static_cast<uint32_t>(m_kinds.size()), static_cast<uint32_t>(size));
+    }
+
+    m_kinds.push_back(static_cast<uint8_t>(kind));
+    m_offsets.push_back(line + static_cast<uint32_t>(column));
+    m_lengths.push_back(static_cast<uint16_t>(std::min<size_t>(size, LONG_LENGTH)));
+    m_line_indices.push_back(static_cast<uint32_t>(m_line_starts.size() - 1));
+    m_ids.push_back(kind == TokenKind::STRING ? m_interner.intern(str(m_kinds.size() - 1)) : NO_SYMBOL);
+}
+
+/**
+ * @brief Append tokens of the lines following this store
+ *
+ * Identifiers of the store are interned again in this store, and ids of
+ * the appended tokens are replaced with the new ones.
+ *
+ * @param[in] store tokens with the same base
+ */
+void
+TokenStore::append(const TokenStore& store) {
+    const auto tokens = static_cast<uint32_t>(m_kinds.size());
+    const auto lines = static_cast<uint32_t>(m_line_starts.size());
+
+    m_kinds.insert(m_kinds.end(), store.m_kinds.begin(), store.m_kinds.end());
+    m_offsets.insert(m_offsets.end(), store.m_offsets.begin(), store.m_offsets.end());
+    m_lengths.insert(m_lengths.end(), store.m_lengths.begin(), store.m_lengths.end());
+    m_line_starts.insert(m_line_starts.end(), store.m_line_starts.begin(), store.m_line_starts.end());
+
+    m_line_indices.reserve(m_line_indices.size() + store.m_line_indices.size());
+    for (auto index : store.m_line_indices) {
+        m_line_indices.push_back(lines + index);
+    }
+    for (const auto& long_length : store.m_long_lengths) {
+        m_long_lengths.emplace_back(tokens + long_length.first, long_length.second);
+    }
+
+    // keywords have the same ids in all interners
+    std::vector<SymbolId> ids(store.m_interner.size());
+    for (SymbolId id = 0; id < ids.size(); id++) {
+        ids[id] = m_interner.intern(store.m_interner.str(id));
+    }
+    m_ids.reserve(m_ids.size() + store.m_ids.size());
+    for (auto id : store.m_ids) {
+        m_ids.push_back(id != NO_SYMBOL ? ids[id] : NO_SYMBOL);
+    }
+}
+
+/**
+ * @brief Return a token, or throw std::out_of_range if index is out of range
+ * @param[in] index index of the token
+ * @return TokenRef the token
+ */
+TokenRef
+TokenStore::at(size_t index) const {
+    if (index >= size())
+        throw std::out_of_range("TokenStore::at");
+
+    return TokenRef(this, index);
+}
+
+/**
+ * @brief Return length of a token which is too long for m_lengths
+ * @param[in] index index of the token (its m_lengths is LONG_LENGTH)
+ * @return size_t size of string of the token
+ */
+size_t
+TokenStore::longLength(size_t index) const {
+    auto it = std::lower_bound(m_long_lengths.begin(), m_long_lengths.end(), std::make_pair(static_cast<uint32_t>(index), uint32_t(0)));
+    return it->second;
+}
+
+/**
+ * @brief Return offset of a byte from m_base
+ * @param[in] ptr a byte which tokens refer to
+ * @return uint32_t the offset
+ */
+uint32_t
+TokenStore::offset(const char* ptr) const {
+    auto diff = static_cast<uint64_t>(ptr - m_base);
+    if (diff > UINT32_MAX)
+        throw std::length_error("TokenStore: source program is larger than 4 GiB");
+
+    return static_cast<uint32_t>(diff);
+}
+
+/**
+ * @brief Operator '==' for TokenStore
+ * @return Result of comparing tokens one by one
+ */
+bool
+operator==(const TokenStore& a, const TokenStore& b) {
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a.token(i) != b.token(i))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Operator '==' for TokenStore and Tokens
+ * @return Result of comparing tokens one by one
+ */
+bool
+operator==(const TokenStore& a, const Tokens& b) {
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a.token(i) != b[i])
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Operator '==' for Tokens and TokenStore
+ * @return Result of comparing tokens one by one
+ */
+bool
+operator==(const Tokens& a, const TokenStore& b) {
+    return b == a;
+}
+
+}  // namespace micro1
@@ -0,0 +1,152 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file bench_lexer.cc
+ * @brief Benchmark for lexer.cc
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/lexer.h"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const char* const GENERATED_FILE = "bench_lexer.asm";
+const uint64_t GENERATED_LINES = 500000;
+const int REPEAT = 5;
+
+/**
+ * @brief Write a large source program for benchmarking
+ * @param[in] filename file name of the source program
+ */
+void
+generateSource(const std::string& filename) {
+    std::ofstream ofs(filename);
+
+    ofs << "TITLE BENCH" << std::endl;
+    for (uint64_t i = 0; i < GENERATED_LINES; i++) {
+        switch (i % 5) {
+            case 0:
+                ofs << "L" << i << ": ADD  1, X\"B3DF (2)   ; comment" << std::endl;
+                break;
+            case 1:
+                ofs << "    LEA  2, -3(1)" << std::endl;
+                break;
+            case 2:
+                ofs << "    B    L" << (i - 2) << "+1" << std::endl;
+                break;
+            case 3:
+                ofs << "    DC   'AB" << std::endl;
+                break;
+            default:
+                ofs << "    WIO  LPT" << std::endl;
+                break;
+        }
+    }
+    ofs << "END" << std::endl;
+}
+
+/**
+ * @brief Measure a lexing path and print its throughput
+ * @param[in] name name of the path
+ * @param[in] run function which loads and tokenizes the source program
+ */
+void
+measure(const std::string& name, std::function<size_t()> run) {
+    double best = 0;
+    size_t bytes = 0;
+
+    for (int i = 0; i < REPEAT; i++) {
+        auto start = std::chrono::steady_clock::now();
+        bytes = run();
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if (seconds > 0 && bytes / seconds > best)
+            best = bytes / seconds;
+    }
+
+    std::cout << std::left << std::setw(10) << name;
+    std::cout << std::right << std::setw(12) << std::fixed << std::setprecision(1) << best / (1024 * 1024) << " MiB/s";
+    std::cout << "  (" << bytes << " bytes)" << std::endl;
+}
+
+}  // namespace
+
+/**
+ * @brief Benchmark for lexical analyzer
+ * @param[in] argc counts of arguments
+ * @param[in] argv a source program to be tokenized (optional)
+ * @return int 0: successfully, 1: file not found
+ */
+int
+main(const int argc, const char** argv) {
+    std::string filename;
+    if (argc > 1) {
+        filename = argv[1];
+    } else {
+        filename = GENERATED_FILE;
+        generateSource(filename);
+    }
+
+    micro1::SourceBuffer probe;
+    if (!probe.open(filename)) {
+        std::cerr << "ERROR: FILE NOT FOUND" << std::endl;
+        return 1;
+    }
+
+    measure("getline", [&filename]() {
+        std::ifstream ifs(filename);
+        micro1::SourceBuffer source(ifs);
+        auto tokens = micro1::tokenize(source);
+        return source.size();
+    });
+    measure("mmap", [&filename]() {
+        micro1::SourceBuffer source;
+        source.open(filename);
+        auto tokens = micro1::tokenize(source);
+        return source.size();
+    });
+    micro1::ThreadPool pool;
+    measure("parallel", [&filename, &pool]() {
+        micro1::SourceBuffer source;
+        source.open(filename);
+        auto tokens = micro1::tokenize(source, pool);
+        return source.size();
+    });
+    measure("stream", [&filename]() {
+        micro1::SourceBuffer source;
+        source.open(filename);
+        micro1::TokenStream stream(source);
+        while (!stream.eof())
+            stream.next();
+        return source.size();
+    });
+
+    return 0;
+}
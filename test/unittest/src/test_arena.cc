@@ -0,0 +1,195 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file test_arena.cc
+ * @brief Test for arena.cc
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/arena.h"
+
+#include "micro1-as/parser.h"
+#include "micro1-as/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+    std::atomic<size_t> allocations(0);
+
+}  // namespace
+
+void*
+operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void
+operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+    TEST(arenaTest, allocate) {
+        micro1::Arena arena(256);
+
+        auto a = static_cast<char*>(arena.allocate(3, 1));
+        auto b = arena.allocate(8, 8);
+        ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(b) % 8);
+        ASSERT_LE(a + 3, static_cast<char*>(b));
+        ASSERT_EQ(1u, arena.blocks());
+
+        // a large allocation doesn't waste the current block
+        auto c = arena.allocate(1000, 16);
+        ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(c) % 16);
+        ASSERT_EQ(2u, arena.blocks());
+        auto d = static_cast<char*>(arena.allocate(8, 8));
+        ASSERT_EQ(static_cast<char*>(b) + 8, d);
+
+        for (int i = 0; i < 100; i++) {
+            arena.allocate(8, 8);
+        }
+        ASSERT_EQ(5u, arena.blocks());
+        ASSERT_EQ(3u + 8 + 1000 + 8 + 800, arena.size());
+    }
+
+    TEST(arenaTest, ArenaAllocator) {
+        micro1::Arena arena;
+        micro1::Arena& child = arena.child();
+
+        using Ints = std::vector<int, micro1::ArenaAllocator<int>>;
+        const micro1::ArenaAllocator<int> from_arena(&arena);
+        const micro1::ArenaAllocator<int> from_child(&child);
+        Ints heap;
+        Ints a(from_arena);
+        Ints b(from_child);
+        for (int i = 0; i < 100; i++) {
+            heap.push_back(i);
+            a.push_back(i);
+            b.push_back(i);
+        }
+
+        ASSERT_EQ(0u, arena.size() % sizeof(int));
+        ASSERT_LE(100 * sizeof(int), arena.size());
+        ASSERT_LE(100 * sizeof(int), child.size());
+        ASSERT_EQ(heap, a);
+        ASSERT_EQ(a, b);
+
+        // a copy is made on the heap, and an assigned container keeps its allocator
+        Ints copy(a);
+        ASSERT_EQ(nullptr, copy.get_allocator().arena());
+        heap = b;
+        ASSERT_EQ(nullptr, heap.get_allocator().arena());
+        heap = std::move(b);
+        ASSERT_EQ(nullptr, heap.get_allocator().arena());
+        ASSERT_EQ(a, heap);
+
+        // the arena moves with the elements when a container is constructed
+        Ints moved(std::move(a));
+        ASSERT_EQ(&arena, moved.get_allocator().arena());
+        ASSERT_TRUE(micro1::ArenaAllocator<char>(&arena) == moved.get_allocator());
+        ASSERT_TRUE(micro1::ArenaAllocator<char>() != moved.get_allocator());
+    }
+
+    TEST(arenaTest, CopyRows) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL: LEA 2, -3(1)\n    B L\nEND\n"));
+
+        micro1::Rows copy;
+        {
+            micro1::Arena arena;
+            auto rows = micro1::parse(source, nullptr, &arena);
+            copy = rows;
+            ASSERT_EQ(&arena, rows.at(1).instruction().get_allocator().arena());
+        }
+
+        // rows which are copied out of an arena outlive it
+        ASSERT_EQ(nullptr, copy.at(1).instruction().get_allocator().arena());
+        ASSERT_EQ(micro1::parse(source), copy);
+    }
+
+    TEST(arenaTest, reset) {
+        micro1::Arena arena(256);
+        arena.child().allocate(8, 8);
+        arena.allocate(8, 8);
+        arena.reset();
+        ASSERT_EQ(0u, arena.size());
+        ASSERT_EQ(0u, arena.blocks());
+
+        auto p = static_cast<char*>(arena.allocate(8, 8));
+        ASSERT_NE(nullptr, p);
+        ASSERT_EQ(8u, arena.size());
+    }
+
+    TEST(arenaTest, parse) {
+        std::string program = "TITLE ARENA\n";
+        const size_t lines = 10000;
+        for (size_t i = 0; i < lines / 2; i++) {
+            program += "    LEA 2, -3(1)\n    ST 1, LOOP+1\n";
+        }
+        program += "LOOP: HLT\nEND\n";
+        micro1::SourceBuffer source(program);
+
+        micro1::Arena arena;
+        const size_t before = allocations;
+        auto rows = micro1::parse(source, nullptr, &arena);
+        const size_t after = allocations;
+
+        // rows take no allocation from the heap one by one
+        ASSERT_EQ(lines + 3, rows.size());
+        ASSERT_LT(after - before, lines / 20);
+        ASSERT_EQ(&arena, rows.at(1).instruction().get_allocator().arena());
+        ASSERT_EQ(micro1::parse(source), rows);
+    }
+
+    TEST(arenaTest, ParallelParse) {
+        std::string program = "TITLE ARENA\n";
+        while (program.size() < 1024 * 1024) {
+            program += "    LEA 2, -3(1)\n    ST 1, LOOP+1\n";
+        }
+        program += "LOOP: HLT\nEND\n";
+        micro1::SourceBuffer source(program);
+        micro1::ThreadPool pool(4);
+
+        micro1::Arena arena;
+        auto rows = micro1::parse(source, pool, nullptr, &arena);
+
+        ASSERT_EQ(micro1::parse(source), rows);
+        ASSERT_NE(nullptr, rows.back().instruction().get_allocator().arena());
+        ASSERT_EQ(0u, arena.size());
+    }
+
+}  // namespace
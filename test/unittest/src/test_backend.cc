@@ -0,0 +1,179 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file test_backend.cc
+ * @brief Test for backend.cc
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/backend.h"
+
+#include "micro1-as/context.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+namespace {
+
+    std::atomic<size_t> allocations(0);
+
+}  // namespace
+
+void*
+operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void
+operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+    /**
+     * @brief Stream buffer which discards output without allocation
+     */
+    class NullBuffer : public std::streambuf {
+    protected:
+        int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    std::string makeProgram(size_t repeat) {
+        std::string program = "TITLE BACKEND\n";
+        for (size_t i = 0; i < repeat; i++) {
+            program += "    LEA 2, -3(1)\n    ADD 1, X\"1F\n    WIO LPT\n    DC 'AB\n    DS 2\n    B *-1\n";
+        }
+        program += "    HLT\nEND\n";
+
+        return program;
+    }
+
+    TEST(backendTest, writeObjectFile) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL: LEA 2, -3(1)\n    DC L\n    B L+1\n    ORG 10\n    HLT\nEND\n"));
+        micro1::AssemblyContext context(source);
+        context.parse();
+        context.resolve();
+
+        std::ostringstream oss;
+        ASSERT_TRUE(micro1::writeObjectFile(context, oss));
+        ASSERT_EQ("MM T\n0000  A6FD\n0001  0000\n0002  E8FF\n0010  EF00", oss.str());
+    }
+
+    TEST(backendTest, writeObjectFileWithError) {
+        micro1::SourceBuffer source(std::string("TITLE T\n    ADD 1 2\nEND\n"));
+        micro1::AssemblyContext context(source);
+        context.parse();
+        context.resolve();
+
+        std::ostringstream oss;
+        ASSERT_FALSE(micro1::writeObjectFile(context, oss));
+        ASSERT_EQ("", oss.str());
+    }
+
+    TEST(backendTest, writeListingFileWithCrossReference) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL: NOP\n    B L\nM: DC L\n    B M\nEND\n"));
+        micro1::AssemblyContext context(source);
+        context.parse();
+        context.resolve();
+        micro1::writeListingFile(context, "test_backend_xref.a", true);
+
+        std::ifstream ifs("test_backend_xref.a");
+        std::string listing((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        const std::string section = "\n\nCROSS REFERENCE(S)\nL: 2 / 3 4\nM: 4 / 5\n";
+        ASSERT_EQ(section, listing.substr(listing.size() - std::min(listing.size(), section.size())));
+    }
+
+    TEST(backendTest, writeListingFileWithDuplicateLabel) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL: NOP\nL: HLT\nEND\n"));
+        micro1::AssemblyContext context(source);
+        context.parse();
+        context.resolve();
+        micro1::writeListingFile(context, "test_backend_duplicate.a");
+
+        std::ifstream ifs("test_backend_duplicate.a");
+        std::string listing((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+        // the first definition is listed as it is, and only the redefinition is an error
+        ASSERT_NE(std::string::npos, listing.find("\n  0000 E 32 00 L: NOP\n"));
+        ASSERT_NE(std::string::npos, listing.find("\nF 0001         L: HLT\n"));
+        ASSERT_NE(std::string::npos, listing.find("THERE WAS 1 ERROR."));
+
+        std::ostringstream oss;
+        ASSERT_FALSE(micro1::writeObjectFile(context, oss));
+    }
+
+    TEST(backendTest, hasError) {
+        // a note alone doesn't stop writing the object
+        micro1::Diagnostics diagnostics = {{1, 0, micro1::DiagnosticCode::PREVIOUS_LABEL}};
+        ASSERT_FALSE(micro1::hasError(diagnostics));
+        diagnostics.push_back({1, 0, micro1::DiagnosticCode::DUPLICATE_LABEL});
+        ASSERT_TRUE(micro1::hasError(diagnostics));
+    }
+
+    /**
+     * @brief Count allocations of the backend for a program
+     * @param[in] repeat number of repeated lines of the program
+     * @return size_t number of allocations
+     */
+    size_t countAllocations(size_t repeat) {
+        micro1::SourceBuffer source(makeProgram(repeat));
+        micro1::AssemblyContext context(source);
+        context.parse();
+        context.resolve();
+
+        // the index of lines is built once at the first line()
+        source.line(1);
+
+        NullBuffer buffer;
+        std::ostream os(&buffer);
+        const size_t before = allocations;
+        micro1::writeObjectFile(context, os);
+        micro1::writeListingFile(context, "test_backend.a");
+
+        return allocations - before;
+    }
+
+    TEST(backendTest, NoAllocationPerRow) {
+        ASSERT_EQ(countAllocations(100), countAllocations(1000));
+    }
+
+}  // namespace
@@ -0,0 +1,157 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file test_context.cc
+ * @brief Test for context.cc
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/context.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+    TEST(contextTest, Resolve) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL: LEA 2, -3(1)\n    B L+1\nM: HLT\n    B M\nEND\n"));
+        micro1::AssemblyContext context(source);
+        context.parse();
+
+        ASSERT_TRUE(context.diagnostics().empty());
+        ASSERT_TRUE(context.symbolTable().empty());
+
+        context.resolve();
+
+        std::vector<micro1::Symbol> expected = {{"L", 0, 1}, {"M", 2, 3}};
+        ASSERT_EQ(expected, context.symbolTable().sorted());
+
+        const auto& rows = context.rows();
+        ASSERT_TRUE(rows[2].raddr().resolved());
+        ASSERT_EQ(0 - 1 + 1, rows[2].raddr().val());
+        ASSERT_TRUE(rows[4].raddr().resolved());
+        ASSERT_EQ(static_cast<micro1::M1Addr>(2 - 3), rows[4].raddr().val());
+    }
+
+    TEST(contextTest, References) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL: NOP\n    B L\nM: DC L\n    B *\n    B M+1\n    BZ L\nN: HLT\nEND\n"));
+        micro1::AssemblyContext context(source);
+        context.parse();
+        context.resolve();
+
+        auto rows = [&context](std::string_view label) {
+            auto references = context.references(label);
+            return std::vector<size_t>(references.begin(), references.end());
+        };
+        ASSERT_EQ((std::vector<size_t>{2, 3, 6}), rows("L"));
+        ASSERT_EQ((std::vector<size_t>{5}), rows("M"));
+        ASSERT_TRUE(rows("N").empty());
+        ASSERT_TRUE(rows("X").empty());
+    }
+
+    TEST(contextTest, DuplicateLabels) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL: NOP\nM: NOP\nL: HLT\n    B L\nL: ADD 1 2\nEND\n"));
+        micro1::AssemblyContext context(source);
+        context.parse();
+        context.resolve();
+
+        // both definitions are reported in order of the rows, and the first one is kept
+        micro1::Diagnostics expected = {
+            {1, 0, micro1::DiagnosticCode::PREVIOUS_LABEL},
+            {3, 0, micro1::DiagnosticCode::DUPLICATE_LABEL},
+            {5, 2, micro1::DiagnosticCode::REQUIRED_COMMA},
+            {5, 0, micro1::DiagnosticCode::DUPLICATE_LABEL},
+        };
+        ASSERT_EQ(expected, context.diagnostics());
+        ASSERT_EQ(0, context.symbolTable().find("L")->addr);
+        ASSERT_TRUE(context.symbolTable().find("L")->duplicate);
+        ASSERT_FALSE(context.symbolTable().find("M")->duplicate);
+    }
+
+    TEST(contextTest, ParallelParse) {
+        std::string program = "TITLE T\n";
+        while (program.size() < 1024 * 1024) {
+            program += "L" + std::to_string(program.size()) + ": B L8\n    ADD 1 2\n";
+        }
+        program += "END\n";
+
+        micro1::SourceBuffer source(program);
+        micro1::ThreadPool pool(4);
+        micro1::AssemblyContext expected(source);
+        micro1::AssemblyContext result(source);
+        expected.parse();
+        result.parse(pool);
+        expected.resolve();
+        result.resolve();
+
+        ASSERT_EQ(expected.rows(), result.rows());
+        ASSERT_EQ(expected.diagnostics(), result.diagnostics());
+        ASSERT_EQ(expected.symbolTable().sorted(), result.symbolTable().sorted());
+    }
+
+    TEST(contextTest, ParallelResolve) {
+        std::string program = "TITLE T\n";
+        for (size_t i = 0; i < 100000; i++) {
+            const auto target = std::to_string(i * 7919 % 100000);
+            program += "L" + std::to_string(i) + ": B L" + target + "+1\n    DC L" + target + "\n    BZ *-2\n    B U\n";
+        }
+        program += "END\n";
+
+        micro1::SourceBuffer source(program);
+        micro1::ThreadPool pool(4);
+        micro1::AssemblyContext expected(source);
+        micro1::AssemblyContext result(source);
+        expected.parse();
+        result.parse();
+        expected.resolve();
+        result.resolve(pool);
+
+        ASSERT_EQ(expected.rows(), result.rows());
+        ASSERT_EQ(expected.diagnostics(), result.diagnostics());
+        for (size_t i = 0; i < expected.symbolTable().size(); i++) {
+            const auto first = expected.crossReference().references(i);
+            const auto second = result.crossReference().references(i);
+            ASSERT_EQ(std::vector<size_t>(first.begin(), first.end()), std::vector<size_t>(second.begin(), second.end()));
+        }
+        ASSERT_EQ(2u, expected.references("L0").size());
+    }
+
+    TEST(contextTest, ParseAgain) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL: ADD 1 2\n    B L\nEND\n"));
+        micro1::AssemblyContext context(source);
+        context.parse();
+        context.resolve();
+        ASSERT_EQ(1u, context.diagnostics().size());
+        ASSERT_EQ(1u, context.symbolTable().size());
+
+        // the rows, the diagnostics and the symbol table are replaced
+        context.parse(1);
+        ASSERT_EQ(1u, context.diagnostics().size());
+        ASSERT_EQ(2u, context.rows().size());
+        ASSERT_TRUE(context.symbolTable().empty());
+    }
+
+}  // namespace
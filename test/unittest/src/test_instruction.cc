@@ -106,4 +106,13 @@ namespace {
         ASSERT_EQ(micro1::InstGroup::INVALID, micro1::getNumberOfGroup("HOGE"));
     }
 
+    TEST(getNumberOfGroupTest, SymbolId) {
+        ASSERT_EQ(micro1::InstGroup::GROUP1, micro1::getNumberOfGroup(micro1::toSymbolId(micro1::Keyword::EX)));
+        ASSERT_EQ(micro1::InstGroup::GROUP6, micro1::getNumberOfGroup(micro1::toSymbolId(micro1::Keyword::B)));
+        ASSERT_EQ(micro1::InstGroup::GROUP9, micro1::getNumberOfGroup(micro1::toSymbolId(micro1::Keyword::ORG)));
+        ASSERT_EQ(micro1::InstGroup::INVALID, micro1::getNumberOfGroup(micro1::toSymbolId(micro1::Keyword::END)));
+        ASSERT_EQ(micro1::InstGroup::INVALID, micro1::getNumberOfGroup(micro1::toSymbolId(micro1::Keyword::NUMBER_OF_KEYWORDS)));
+        ASSERT_EQ(micro1::InstGroup::INVALID, micro1::getNumberOfGroup(micro1::NO_SYMBOL));
+    }
+
 }
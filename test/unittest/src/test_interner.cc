@@ -0,0 +1,75 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file test_interner.cc
+ * @brief Test for interner.cc
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/interner.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+    TEST(internerTest, Keyword) {
+        micro1::Interner interner;
+
+        ASSERT_EQ(static_cast<size_t>(micro1::Keyword::NUMBER_OF_KEYWORDS), interner.size());
+        ASSERT_EQ(micro1::toSymbolId(micro1::Keyword::ADD), interner.find("ADD"));
+        ASSERT_EQ(micro1::toSymbolId(micro1::Keyword::B), interner.intern("B"));
+        ASSERT_EQ(micro1::toSymbolId(micro1::Keyword::TITLE), interner.find("TITLE"));
+        ASSERT_EQ(micro1::toSymbolId(micro1::Keyword::O), interner.find("O"));
+        ASSERT_EQ("LPT", interner.str(micro1::toSymbolId(micro1::Keyword::LPT)));
+        ASSERT_EQ(micro1::NO_SYMBOL, interner.find("add"));
+    }
+
+    TEST(internerTest, findKeyword) {
+        micro1::Interner interner;
+
+        for (micro1::SymbolId id = 0; id < micro1::toSymbolId(micro1::Keyword::NUMBER_OF_KEYWORDS); id++) {
+            ASSERT_EQ(id, micro1::findKeyword(interner.str(id)));
+        }
+        for (auto str : {"", "A", "ADDX", "TITLES", "add", "BDISX", "LOOP", "X1", "ORG "}) {
+            ASSERT_EQ(micro1::NO_SYMBOL, micro1::findKeyword(str)) << str;
+        }
+    }
+
+    TEST(internerTest, intern) {
+        micro1::Interner interner;
+        const std::string source = "LOOP START LOOP";
+
+        auto loop = interner.intern(std::string_view(source).substr(0, 4));
+        auto start = interner.intern(std::string_view(source).substr(5, 5));
+
+        ASSERT_EQ(micro1::toSymbolId(micro1::Keyword::NUMBER_OF_KEYWORDS), loop);
+        ASSERT_EQ(loop + 1, start);
+        ASSERT_EQ(loop, interner.intern(std::string_view(source).substr(11, 4)));
+        ASSERT_EQ(start, interner.find("START"));
+        ASSERT_EQ("LOOP", interner.str(loop));
+        ASSERT_EQ(static_cast<size_t>(start) + 1, interner.size());
+    }
+
+}
@@ -29,11 +29,19 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 namespace {
 
     TEST(tokenizeTest, STRING) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_STRING.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::STRING,  "  ABC       D012    EFGhij     ", 3, 1,  2),
@@ -49,7 +57,7 @@ namespace {
             micro1::Token(micro1::TokenKind::STRING,  " EGG  SYSTEM FT",                 2, 3, 13),
             micro1::Token(micro1::TokenKind::EOL,     " EGG  SYSTEM FT",                 1, 3, 15)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -57,6 +65,7 @@ namespace {
     TEST(tokenizeTest, INTEGER) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_INTEGER.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::INTEGER, "1234 5678 90AB",   4, 1,  0),
@@ -71,7 +80,7 @@ namespace {
             micro1::Token(micro1::TokenKind::INTEGER, " 6AB1 8EB3 0D12",  4, 3, 11),
             micro1::Token(micro1::TokenKind::EOL,     " 6AB1 8EB3 0D12",  1, 3, 15)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -80,6 +89,7 @@ namespace {
     TEST(tokenizeTest, LPAREN) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_LPAREN.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::LPAREN, "    (   ( ", 1, 1,  4),
@@ -91,7 +101,7 @@ namespace {
             micro1::Token(micro1::TokenKind::LPAREN, "  (",        1, 3,  2),
             micro1::Token(micro1::TokenKind::EOL,    "  (",        1, 3,  3)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -99,6 +109,7 @@ namespace {
     TEST(tokenizeTest, RPAREN) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_RPAREN.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::RPAREN, ")   )  ) ) ", 1, 1,  0),
@@ -115,7 +126,7 @@ namespace {
             micro1::Token(micro1::TokenKind::RPAREN, " )  )",       1, 3,  4),
             micro1::Token(micro1::TokenKind::EOL,    " )  )",       1, 3,  5)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -123,6 +134,7 @@ namespace {
     TEST(tokenizeTest, STAR) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_STAR.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::STAR, "*  *  ***", 1, 1,  0),
@@ -143,7 +155,7 @@ namespace {
             micro1::Token(micro1::TokenKind::STAR, "** *  * ",  1, 3,  6),
             micro1::Token(micro1::TokenKind::EOL,  "** *  * ",  1, 3,  8)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -151,6 +163,7 @@ namespace {
     TEST(tokenizeTest, CHARS) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_CHARS.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::CHARS, "'AB  '1F   'F6",  3, 1,  0),
@@ -166,7 +179,7 @@ namespace {
             micro1::Token(micro1::TokenKind::CHARS, " '%' '  '#\" ",   3, 3,  8),
             micro1::Token(micro1::TokenKind::EOL,   " '%' '  '#\" ",   1, 3, 12)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -174,6 +187,7 @@ namespace {
     TEST(tokenizeTest, DQUOTE) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_DQUOTE.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::DQUOTE, "\"   \"  \"  ",  1, 1,  0),
@@ -189,7 +203,7 @@ namespace {
             micro1::Token(micro1::TokenKind::DQUOTE, " \"   \"    \"", 1, 3, 10),
             micro1::Token(micro1::TokenKind::EOL,    " \"   \"    \"", 1, 3, 11)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -197,6 +211,7 @@ namespace {
     TEST(tokenizeTest, SIGN) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_SIGN.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::SIGN, "+  +     +",  1, 1,  0),
@@ -213,7 +228,7 @@ namespace {
             micro1::Token(micro1::TokenKind::SIGN, "     -+  +-", 1, 3, 10),
             micro1::Token(micro1::TokenKind::EOL,  "     -+  +-", 1, 3, 11)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -221,6 +236,7 @@ namespace {
     TEST(tokenizeTest, COMMA) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_COMMA.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::COMMA, ",  , ,",    1, 1,  0),
@@ -236,7 +252,7 @@ namespace {
             micro1::Token(micro1::TokenKind::COMMA, "  ,   ,,",  1, 3,  7),
             micro1::Token(micro1::TokenKind::EOL,   "  ,   ,,",  1, 3,  8)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -244,6 +260,7 @@ namespace {
     TEST(tokenizeTest, COLON) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_COLON.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::COLON, ":   : :",          1, 1,  0),
@@ -259,7 +276,7 @@ namespace {
             micro1::Token(micro1::TokenKind::COLON, " :     :   :    ", 1, 3, 11),
             micro1::Token(micro1::TokenKind::EOL,   " :     :   :    ", 1, 3, 16)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
 
         ASSERT_EQ(expected, result);
     }
@@ -267,6 +284,7 @@ namespace {
     TEST(tokenizeTest, INVALID) {
         std::ifstream ifs("test/unittest/input/input_for_lexer_INVALID.in");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Tokens expected = {
             micro1::Token(micro1::TokenKind::INVALID, "& $  ~", 1, 1,  0),
@@ -282,9 +300,138 @@ namespace {
             micro1::Token(micro1::TokenKind::INVALID, " [ / ]", 1, 3,  5),
             micro1::Token(micro1::TokenKind::EOL,     " [ / ]", 1, 3,  6)
         };
-        auto result = micro1::tokenize(ifs);
+        auto result = micro1::tokenize(source);
+
+        ASSERT_EQ(expected, result);
+    }
+
+    TEST(tokenizeTest, SourceBuffer) {
+        micro1::SourceBuffer source(std::string("  ADD 1, 2\nEND"));
+
+        auto result = micro1::tokenize(source);
+
+        ASSERT_EQ(7u, result.size());
+        for (auto token : result) {
+            ASSERT_GE(token.str().data(), source.data().data());
+            ASSERT_LE(token.str().data() + token.str().size(), source.data().data() + source.size());
+        }
+        ASSERT_EQ("END", result.at(5).str());
+        ASSERT_EQ(2u, result.at(6).row());
+    }
+
+    TEST(tokenizeTest, LineIndex) {
+        micro1::SourceBuffer source(std::string("TITLE T\n\n  ADD 1, 2 ; comment\nEND"));
+
+        ASSERT_EQ("TITLE T", source.line(1));
+        ASSERT_EQ("", source.line(2));
+        ASSERT_EQ("  ADD 1, 2 ; comment", source.line(3));
+        ASSERT_EQ("END", source.line(4));
+        ASSERT_EQ("", source.line(5));
+        ASSERT_EQ("", source.line(0));
+
+        auto result = micro1::tokenize(source);
+        ASSERT_EQ(source.line(3), source.line(result.at(4).row()));
+    }
+
+    TEST(tokenizeTest, MappedFile) {
+        std::ifstream ifs("test/unittest/input/input_for_lexer_STRING.in");
+        ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer expected_source(ifs);
+        micro1::SourceBuffer source;
+        ASSERT_TRUE(source.open("test/unittest/input/input_for_lexer_STRING.in"));
+
+        ASSERT_EQ(micro1::tokenize(expected_source), micro1::tokenize(source));
+        ASSERT_FALSE(source.open("test/unittest/input/not_found.in"));
+    }
+
+    TEST(tokenizeTest, TokenStream) {
+        micro1::SourceBuffer source(std::string("TITLE T\n\n  ADD 1, 2 ; comment\nEND"));
+        auto expected = micro1::tokenize(source);
 
+        micro1::TokenStream stream(source);
+        ASSERT_EQ("TITLE", stream.peek(0).str());
+        ASSERT_EQ("T", stream.peek(1).str());
+        ASSERT_EQ(micro1::TokenKind::EOL, stream.peek(2).kind());
+        ASSERT_FALSE(stream.peek(3));
+
+        micro1::Tokens result;
+        for (; !stream.eof(); stream.next()) {
+            result.emplace_back(stream.peek().token());
+        }
         ASSERT_EQ(expected, result);
+        ASSERT_FALSE(stream.peek());
+    }
+
+    TEST(tokenizeTest, Parallel) {
+        std::string program = "TITLE PARALLEL\n";
+        for (int i = 0; program.size() < 1024 * 1024; i++) {
+            program += "L" + std::to_string(i) + ": ADD 1, X\"1F ; comment\n\n    LEA 2, -3(1)\n";
+        }
+        program += "END";
+        micro1::SourceBuffer source(program);
+        micro1::ThreadPool pool(4);
+
+        auto expected = micro1::tokenize(source);
+        auto result = micro1::tokenize(source, pool);
+
+        ASSERT_EQ(expected, result);
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_EQ(expected.id(i), result.id(i)) << i;
+        }
+        ASSERT_EQ(static_cast<uint64_t>(std::count(program.begin(), program.end(), '\n')) + 1, result.back().row());
+    }
+
+    TEST(tokenizeTest, TokenStore) {
+        const std::string label(70000, 'L');
+        micro1::SourceBuffer source(std::string("TITLE T\n") + label + ": NOP\n" + label);
+
+        auto result = micro1::tokenize(source);
+
+        ASSERT_EQ(9u, result.size());
+        ASSERT_EQ(result.size(), result.kinds().size());
+        ASSERT_EQ(micro1::TokenKind::STRING, result.kind(3));
+        ASSERT_EQ(label, result.at(3).str());
+        ASSERT_EQ(micro1::TokenKind::COLON, result.at(4).kind());
+        ASSERT_EQ(70000u, result.at(4).column());
+        ASSERT_EQ(label, result.at(7).str());
+        ASSERT_EQ(3u, result.back().row());
+        ASSERT_EQ(label, source.line(result.back().row()));
+        ASSERT_THROW(result.at(9), std::out_of_range);
+    }
+
+    TEST(tokenizeTest, Interning) {
+        micro1::SourceBuffer source(std::string("LOOP: B LOOP\n  WIO LPT\n  DC X\"1F"));
+
+        auto result = micro1::tokenize(source);
+
+        ASSERT_EQ(micro1::toSymbolId(micro1::Keyword::NUMBER_OF_KEYWORDS), result.id(0));
+        ASSERT_EQ(micro1::NO_SYMBOL, result.id(1));
+        ASSERT_TRUE(result.at(2).is(micro1::Keyword::B));
+        ASSERT_EQ(result.id(0), result.id(3));
+        ASSERT_TRUE(result.at(5).is(micro1::Keyword::WIO));
+        ASSERT_TRUE(result.token(6).is(micro1::Keyword::LPT));
+        ASSERT_TRUE(result.at(9).is(micro1::Keyword::X));
+        ASSERT_EQ(micro1::NO_SYMBOL, result.id(11));
+        ASSERT_EQ("LOOP", result.interner().str(result.id(0)));
+    }
+
+    TEST(tokenizeTest, InMemory) {
+        const std::string program = "TITLE MEMORY\nL: LEA 2, -3(1)\nEND\n";
+        micro1::SourceBuffer source(program);
+        auto expected = micro1::tokenize(source);
+
+        auto from_view = micro1::tokenize(std::string_view(program));
+        ASSERT_EQ(expected, from_view);
+        ASSERT_EQ(program.data() + 13, from_view.at(3).str().data());
+
+        const std::vector<unsigned char> bytes(program.begin(), program.end());
+        ASSERT_EQ(expected, micro1::tokenize(bytes.data(), bytes.size()));
+
+        std::istringstream iss(program);
+        ASSERT_EQ(expected, micro1::tokenize(iss));
+
+        micro1::TokenStream stream{std::string_view(program)};
+        ASSERT_EQ("TITLE", stream.peek().str());
     }
 
 }
@@ -26,16 +26,22 @@
  */
 
 #include "micro1-as/parser.h"
+#include "micro1-as/document.h"
 
 #include "micro1-as/lexer.h"
+#include "micro1-as/thread_pool.h"
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <string>
+
 namespace {
 
     TEST(parseTest, GROUP1) {
         std::ifstream ifs("test/unittest/input/input_for_parser_GROUP1.asm");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Rows expected = {
             micro1::Row(
@@ -45,7 +51,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP1",           5,  1,  0),
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP1",          20,  1,  6)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -60,7 +65,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    ADD  1, 37 (0)",                   1,  2, 16),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    ADD  1, 37 (0)",                   1,  2, 17)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -77,7 +81,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    SUB  2, X\"B3DF (1)",              1,  3, 20),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    SUB  2, X\"B3DF (1)",              1,  3, 21)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -94,7 +97,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    AND  3, O\"314232 (2)",            1,  4, 22),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    AND  3, O\"314232 (2)",            1,  4, 23)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -111,7 +113,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    OR   0, B\"1010010110100101 (3)",  1,  5, 32),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    OR   0, B\"1010010110100101 (3)",  1,  5, 33)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -123,7 +124,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::COMMA,   "    XOR  1, 43",                       1,  6, 10),
                     micro1::Token(micro1::TokenKind::INTEGER, "    XOR  1, 43",                       2,  6, 12)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -137,7 +137,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    MULT 2, X\"B2F2",                  1,  7, 13),
                     micro1::Token(micro1::TokenKind::STRING,  "    MULT 2, X\"B2F2",                  4,  7, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -151,7 +150,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    DIV  3, O\"172712",                1,  8, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    DIV  3, O\"172712",                6,  8, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -165,7 +163,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    CMP  0, B\"1011010011001101",      1,  9, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    CMP  0, B\"1011010011001101",     16,  9, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -179,7 +176,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    EX   1, (0)",                      1, 10, 13),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    EX   1, (0)",                      1, 10, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -188,11 +184,10 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "END",                                  3, 11,  0)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             )
         };
-        auto result = micro1::parse(micro1::tokenize(ifs));
+        auto result = micro1::parse(micro1::tokenize(source));
 
         ASSERT_EQ(expected, result);
     }
@@ -200,6 +195,7 @@ namespace {
     TEST(parseTest, GROUP2) {
         std::ifstream ifs("test/unittest/input/input_for_parser_GROUP2.asm");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Rows expected = {
             micro1::Row(
@@ -209,7 +205,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP2",       5,  1,  0),
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP2",      20,  1,  6)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -221,7 +216,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::COMMA,   "    LC   0, 108",                  1,  2, 10),
                     micro1::Token(micro1::TokenKind::INTEGER, "    LC   0, 108",                  3,  2, 12)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -235,7 +229,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    PUSH 1, X\"E0B3",              1,  3, 13),
                     micro1::Token(micro1::TokenKind::STRING,  "    PUSH 1, X\"E0B3",              4,  3, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -249,7 +242,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    POP  2, O\"173210",            1,  4, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    POP  2, O\"173210",            6,  4, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -263,7 +255,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    LC   3, B\"1001010101101001",  1,  5, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    LC   3, B\"1001010101101001", 16,  5, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -272,11 +263,10 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "END",                              3,  6,  0)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             )
         };
-        auto result = micro1::parse(micro1::tokenize(ifs));
+        auto result = micro1::parse(micro1::tokenize(source));
 
         ASSERT_EQ(expected, result);
     }
@@ -284,6 +274,7 @@ namespace {
     TEST(parseTest, GROUP3) {
         std::ifstream ifs("test/unittest/input/input_for_parser_GROUP3.asm");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Rows expected = {
             micro1::Row(
@@ -293,7 +284,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP3",       5,  1,  0),
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP3",      20,  1,  6)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -305,7 +295,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::COMMA,   "    SL  0, 4",                     1,  2,  9),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SL  0, 4",                     1,  2, 11)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -318,7 +307,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "    SA  1, +34",                   1,  3, 11),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SA  1, +34",                   2,  3, 12)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -331,7 +319,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "    SC  2, -49",                   1,  4, 11),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SC  2, -49",                   2,  4, 12)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -345,7 +332,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    BIX 3, X\"B24F",               1,  5, 12),
                     micro1::Token(micro1::TokenKind::STRING,  "    BIX 3, X\"B24F",               4,  5, 13)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -360,7 +346,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    SL  0, +X\"3BA",               1,  6, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SL  0, +X\"3BA",               3,  6, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -375,7 +360,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    SA  1, -X\"23AA",              1,  7, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SA  1, -X\"23AA",              4,  7, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -389,7 +373,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    SC  2, O\"36723",              1,  8, 12),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SC  2, O\"36723",              5,  8, 13)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -404,7 +387,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    BIX 3, +O\"21734",             1,  9, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    BIX 3, +O\"21734",             5,  9, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -419,7 +401,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    SL  0, -O\"3234",              1, 10, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SL  0, -O\"3234",              4, 10, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -433,7 +414,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    SA  1, B\"1010100",            1, 11, 12),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SA  1, B\"1010100",            7, 11, 13)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -448,7 +428,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    SC  2, +B\"101010110010110",   1, 12, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    SC  2, +B\"101010110010110",  15, 12, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -463,7 +442,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::DQUOTE,  "    BIX 3, -B\"10101001001",       1, 13, 13),
                     micro1::Token(micro1::TokenKind::INTEGER, "    BIX 3, -B\"10101001001",      11, 13, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -472,11 +450,10 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "END",                              3, 14,  0)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             )
         };
-        auto result = micro1::parse(micro1::tokenize(ifs));
+        auto result = micro1::parse(micro1::tokenize(source));
 
         ASSERT_EQ(expected, result);
     }
@@ -484,6 +461,7 @@ namespace {
     TEST(parseTest, GROUP4) {
         std::ifstream ifs("test/unittest/input/input_for_parser_GROUP4.asm");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Rows expected = {
             micro1::Row(
@@ -493,7 +471,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP4",       5,  1,  0),
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP4",      20,  1,  6)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -508,7 +485,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LEA 0,87 (3) ",                1,  2, 14),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LEA 0,87 (3) ",                1,  2, 15)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -524,7 +500,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LX  1, +124 (0)",              1,  3, 17),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LX  1, +124 (0)",              1,  3, 18)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -540,7 +515,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    STX 2, -93 (1)",               1,  4, 16),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    STX 2, -93 (1)",               1,  4, 17)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -557,7 +531,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LEA 3, X\"39 (2)",             1,  5, 17),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LEA 3, X\"39 (2)",             1,  5, 18)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -575,7 +548,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LX  0, +X\"C23 (3)",           1,  6, 19),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LX  0, +X\"C23 (3)",           1,  6, 20)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -593,7 +565,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    STX 1, -X\"23D (0)",           1,  7, 19),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    STX 1, -X\"23D (0)",           1,  7, 20)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -610,7 +581,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LEA 2, O\"3723 (1)",           1,  8, 19),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LEA 2, O\"3723 (1)",           1,  8, 20)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -628,7 +598,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LX  3, +O\"3243 (2)",          1,  9, 20),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LX  3, +O\"3243 (2)",          1,  9, 21)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -646,7 +615,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    STX 0, -O\"42 (3)",            1, 10, 18),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    STX 0, -O\"42 (3)",            1, 10, 19)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -663,7 +631,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LEA 1, B\"10101101 (0)",       1, 11, 23),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LEA 1, B\"10101101 (0)",       1, 11, 24)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -681,7 +648,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LX  2, +B\"11010 (1)",         1, 12, 21),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LX  2, +B\"11010 (1)",         1, 12, 22)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -699,7 +665,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    STX 3, -B\"10010111 (2)",      1, 13, 24),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    STX 3, -B\"10010111 (2)",      1, 13, 25)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -713,7 +678,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::INTEGER, "    LEA 0, (3)",                   1, 14, 12),
                     micro1::Token(micro1::TokenKind::RPAREN,  "    LEA 0, (3)",                   1, 14, 13)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -722,11 +686,10 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "END",                              3, 15,  0)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             )
         };
-        auto result = micro1::parse(micro1::tokenize(ifs));
+        auto result = micro1::parse(micro1::tokenize(source));
 
         ASSERT_EQ(expected, result);
     }
@@ -734,6 +697,7 @@ namespace {
     TEST(parseTest, GROUP5) {
         std::ifstream ifs("test/unittest/input/input_for_parser_GROUP5.asm");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Rows expected = {
             micro1::Row(
@@ -743,7 +707,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP5",       5,  1,  0),
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP5",      20,  1,  6)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -755,7 +718,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::COMMA,   "      L  0, *",                    1,  2, 10),
                     micro1::Token(micro1::TokenKind::STAR,    "      L  0, *",                    1,  2, 12)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", 0 }
             ),
             micro1::Row(
@@ -769,7 +731,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "      ST 1, * + 8",                1,  3, 14),
                     micro1::Token(micro1::TokenKind::INTEGER, "      ST 1, * + 8",                1,  3, 16)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", 8 }
             ),
             micro1::Row(
@@ -783,7 +744,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "      LA 2, * - 92",               1,  4, 14),
                     micro1::Token(micro1::TokenKind::INTEGER, "      LA 2, * - 92",               2,  4, 16)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", -92 }
             ),
             micro1::Row(
@@ -793,7 +753,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "      ORG 100",                    3,  5,  6),
                     micro1::Token(micro1::TokenKind::INTEGER, "      ORG 100",                    3,  5, 10)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -805,7 +764,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::COMMA,   "HOGE: L  3, HOGE",                 1,  6, 10),
                     micro1::Token(micro1::TokenKind::STRING,  "HOGE: L  3, HOGE",                 4,  6, 12)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "HOGE", 0 }
             ),
             micro1::Row(
@@ -819,7 +777,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "      ST 0, HOGE + 23",            1,  7, 17),
                     micro1::Token(micro1::TokenKind::INTEGER, "      ST 0, HOGE + 23",            2,  7, 19)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "HOGE", 23 }
             ),
             micro1::Row(
@@ -833,7 +790,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "      LA 1, HOGE - 12",            1,  8, 17),
                     micro1::Token(micro1::TokenKind::INTEGER, "      LA 1, HOGE - 12",            2,  8, 19)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "HOGE", -12 }
             ),
             micro1::Row(
@@ -842,11 +798,10 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "END",                              3,  9,  0)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             )
         };
-        auto result = micro1::parse(micro1::tokenize(ifs));
+        auto result = micro1::parse(micro1::tokenize(source));
 
         ASSERT_EQ(expected, result);
     }
@@ -854,6 +809,7 @@ namespace {
     TEST(parseTest, GROUP6) {
         std::ifstream ifs("test/unittest/input/input_for_parser_GROUP6.asm");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Rows expected = {
             micro1::Row(
@@ -863,7 +819,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP6",       5,  1,  0),
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP6",      20,  1,  6)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -873,7 +828,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "         BDIS *",                  4,  2,  9),
                     micro1::Token(micro1::TokenKind::STAR,    "         BDIS *",                  1,  2, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", 0 }
             ),
             micro1::Row(
@@ -885,7 +839,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "         BP   * + 34",             1,  3, 16),
                     micro1::Token(micro1::TokenKind::INTEGER, "         BP   * + 34",             2,  3, 18)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", 34 }
             ),
             micro1::Row(
@@ -897,7 +850,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "         BZ   * - 32",             1,  4, 16),
                     micro1::Token(micro1::TokenKind::INTEGER, "         BZ   * - 32",             2,  4, 18)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", -32 }
             ),
             micro1::Row(
@@ -907,7 +859,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "         ORG 10",                  3,  5,  9),
                     micro1::Token(micro1::TokenKind::INTEGER, "         ORG 10",                  2,  5, 13)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -917,7 +868,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "SAMPLE:  BM   SAMPLE",             2,  6,  9),
                     micro1::Token(micro1::TokenKind::STRING,  "SAMPLE:  BM   SAMPLE",             6,  6, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "SAMPLE", 0 }
             ),
             micro1::Row(
@@ -929,7 +879,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "         BC   SAMPLE + 23",        1,  7, 21),
                     micro1::Token(micro1::TokenKind::INTEGER, "         BC   SAMPLE + 23",        2,  7, 23)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "SAMPLE", 23 }
             ),
             micro1::Row(
@@ -941,7 +890,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "         BNP  SAMPLE - 3",         1,  8, 21),
                     micro1::Token(micro1::TokenKind::INTEGER, "         BNP  SAMPLE - 3",         1,  8, 23)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "SAMPLE", -3 }
             ),
             micro1::Row(
@@ -951,7 +899,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "         BNZ  *",                  3,  9,  9),
                     micro1::Token(micro1::TokenKind::STAR,    "         BNZ  *",                  1,  9, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", 0 }
             ),
             micro1::Row(
@@ -963,7 +910,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "         BNM  * + 87",             1, 10, 16),
                     micro1::Token(micro1::TokenKind::INTEGER, "         BNM  * + 87",             2, 10, 18)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", 87 }
             ),
             micro1::Row(
@@ -975,7 +921,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "         BNC  * - 98",             1, 11, 16),
                     micro1::Token(micro1::TokenKind::INTEGER, "         BNC  * - 98",             2, 11, 18)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "*", -98 }
             ),
             micro1::Row(
@@ -985,7 +930,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "         B    SAMPLE",             1, 12,  9),
                     micro1::Token(micro1::TokenKind::STRING,  "         B    SAMPLE",             6, 12, 14)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "SAMPLE", 0 }
             ),
             micro1::Row(
@@ -997,7 +941,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "         BI   SAMPLE + 81",        1, 13, 21),
                     micro1::Token(micro1::TokenKind::INTEGER, "         BI   SAMPLE + 81",        2, 13, 23)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "SAMPLE", 81 }
             ),
             micro1::Row(
@@ -1009,7 +952,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::SIGN,    "         BSR  SAMPLE - 98",        1, 14, 21),
                     micro1::Token(micro1::TokenKind::INTEGER, "         BSR  SAMPLE - 98",        2, 14, 23)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "SAMPLE", -98 }
             ),
             micro1::Row(
@@ -1018,11 +960,10 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "END",                              3, 15,  0)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             )
         };
-        auto result = micro1::parse(micro1::tokenize(ifs));
+        auto result = micro1::parse(micro1::tokenize(source));
 
         ASSERT_EQ(expected, result);
     }
@@ -1030,6 +971,7 @@ namespace {
     TEST(parseTest, GROUP7) {
         std::ifstream ifs("test/unittest/input/input_for_parser_GROUP7.asm");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Rows expected = {
             micro1::Row(
@@ -1039,7 +981,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP7",       5,  1,  0),
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP7",      20,  1,  6)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1049,7 +990,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "    RIO CR",                       3,  2,  4),
                     micro1::Token(micro1::TokenKind::STRING,  "    RIO CR",                       2,  2,  8)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1059,7 +999,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "    WIO LPT",                      3,  3,  4),
                     micro1::Token(micro1::TokenKind::STRING,  "    WIO LPT",                      3,  3,  8)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1069,7 +1008,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "    RIO 0",                        3,  4,  4),
                     micro1::Token(micro1::TokenKind::INTEGER, "    RIO 0",                        1,  4,  8)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1079,7 +1017,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "    WIO 1",                        3,  5,  4),
                     micro1::Token(micro1::TokenKind::INTEGER, "    WIO 1",                        1,  5,  8)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1088,11 +1025,10 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "END",                              3,  6,  0)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             )
         };
-        auto result = micro1::parse(micro1::tokenize(ifs));
+        auto result = micro1::parse(micro1::tokenize(source));
 
         ASSERT_EQ(expected, result);
     }
@@ -1100,6 +1036,7 @@ namespace {
     TEST(parseTest, GROUP8) {
         std::ifstream ifs("test/unittest/input/input_for_parser_GROUP8.asm");
         ASSERT_FALSE(ifs.fail());
+        micro1::SourceBuffer source(ifs);
 
         micro1::Rows expected = {
             micro1::Row(
@@ -1109,7 +1046,6 @@ namespace {
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP8",       5,  1,  0),
                     micro1::Token(micro1::TokenKind::STRING,  "TITLE InputForParserGROUP8",      20,  1,  6)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1118,7 +1054,6 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "    RET",                          3,  2,  4)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1127,7 +1062,6 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "    NOP",                          3,  3,  4)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1136,7 +1070,6 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "    HLT",                          3,  4,  4)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             ),
             micro1::Row(
@@ -1145,13 +1078,387 @@ namespace {
                 {
                     micro1::Token(micro1::TokenKind::STRING,  "END",                              3,  5,  0)
                 },
-                { micro1::DebugInfoImportance::INFO, "", 0 },
                 { "", 0 }
             )
         };
-        auto result = micro1::parse(micro1::tokenize(ifs));
+        auto result = micro1::parse(micro1::tokenize(source));
 
         ASSERT_EQ(expected, result);
     }
 
+    TEST(parseTest, TokenStream) {
+        for (int group = 1; group <= 9; group++) {
+            std::ifstream ifs("test/unittest/input/input_for_parser_GROUP" + std::to_string(group) + ".asm");
+            ASSERT_FALSE(ifs.fail());
+            micro1::SourceBuffer source(ifs);
+
+            micro1::TokenStream stream(source);
+            ASSERT_EQ(micro1::parse(micro1::tokenize(source)), micro1::parse(stream)) << group;
+            ASSERT_EQ(micro1::parse(micro1::tokenize(source)), micro1::parse(source)) << group;
+        }
+    }
+
+    TEST(parseTest, OperandOnNextLine) {
+        micro1::SourceBuffer source(std::string("TITLE T\n  ADD 1, X\"\n  B L+\n10\nEND\n"));
+
+        micro1::TokenStream stream(source);
+        micro1::Diagnostics diagnostics;
+        auto result = micro1::parse(stream, &diagnostics);
+
+        ASSERT_EQ(5u, result.size());
+        ASSERT_EQ(3u, diagnostics.size());
+        ASSERT_EQ(1u, diagnostics.at(0).row);
+        ASSERT_EQ(2u, result.at(1).instruction().back().row());
+        ASSERT_EQ(2u, diagnostics.at(1).row);
+        ASSERT_EQ(3u, result.at(2).instruction().back().row());
+        ASSERT_EQ(micro1::DiagnosticCode::REQUIRED_LABEL_OR_OPECODE, diagnostics.at(2).code);
+        ASSERT_EQ("END", result.at(4).instruction().front().str());
+    }
+
+    TEST(parseTest, Diagnostics) {
+        micro1::SourceBuffer source(std::string("TITLE T\n  ADD 1 2\n  NOP\n  WIO 2\n  FOO\nEND 1\n"));
+
+        micro1::Diagnostics diagnostics;
+        auto result = micro1::parse(source, &diagnostics);
+
+        micro1::Diagnostics expected = {
+            { 1, 2, micro1::DiagnosticCode::REQUIRED_COMMA },
+            { 3, 1, micro1::DiagnosticCode::UNKNOWN_DEVICE_NUMBER },
+            { 4, 0, micro1::DiagnosticCode::UNKNOWN_OPECODE },
+            { 5, 1, micro1::DiagnosticCode::TOO_MANY_TOKENS }
+        };
+        ASSERT_EQ(6u, result.size());
+        ASSERT_EQ(expected, diagnostics);
+        ASSERT_STREQ("Required comma.", micro1::getMessage(diagnostics.at(0).code));
+        ASSERT_STREQ("Too many tokens.", micro1::getMessage(diagnostics.at(3).code));
+        ASSERT_STREQ("", micro1::getMessage(micro1::DiagnosticCode::NONE));
+    }
+
+    TEST(parseTest, MissingOperandOfDSAndORG) {
+        micro1::SourceBuffer source(std::string("TITLE T\n    DS\n    NOP\n    ORG\n    NOP\nEND\n"));
+
+        micro1::Diagnostics diagnostics;
+        auto result = micro1::parse(source, &diagnostics);
+
+        // the error is at the end of the line of DS or ORG, and the next lines are correct
+        micro1::Diagnostics expected = {
+            { 1, 1, micro1::DiagnosticCode::REQUIRED_DECIMAL },
+            { 3, 1, micro1::DiagnosticCode::REQUIRED_HEXADECIMAL }
+        };
+        ASSERT_EQ(expected, diagnostics);
+        ASSERT_EQ(2u, result.at(1).instruction().at(1).row());
+        ASSERT_EQ(6u, result.at(1).instruction().at(1).column());
+        ASSERT_EQ(4u, result.at(3).instruction().at(1).row());
+        ASSERT_EQ(7u, result.at(3).instruction().at(1).column());
+    }
+
+    TEST(parseTest, AddressOffset) {
+        micro1::SourceBuffer source(std::string("TITLE T\nL:  B L+99999999999\n    B L-65535\n    B L+000000001\n    B L+65536\nEND\n"));
+
+        micro1::Diagnostics diagnostics;
+        auto result = micro1::parse(source, &diagnostics);
+
+        micro1::Diagnostics expected = {
+            { 1, 3, micro1::DiagnosticCode::OFFSET_OUT_OF_RANGE },
+            { 4, 3, micro1::DiagnosticCode::OFFSET_OUT_OF_RANGE }
+        };
+        ASSERT_EQ(expected, diagnostics);
+        ASSERT_EQ(-65535, result.at(2).raddr().offset());
+        ASSERT_EQ(1, result.at(3).raddr().offset());
+    }
+
+    TEST(parseTest, Operands) {
+        micro1::SourceBuffer source(std::string("TITLE T\n  LEA 2, -3(1)\n  ADD 1, X\"1F\n  WIO LPT\n  DC 'AB\n  DC L\nL: ORG 1F\nEND\n"));
+
+        auto result = micro1::parse(source);
+
+        ASSERT_EQ(8u, result.size());
+        const auto& lea = result.at(1).operands();
+        ASSERT_EQ(micro1::toSymbolId(micro1::Keyword::LEA), lea.opecode);
+        ASSERT_EQ(micro1::InstGroup::GROUP4, lea.group);
+        ASSERT_EQ(2u, lea.rb);
+        ASSERT_EQ(1u, lea.ra);
+        ASSERT_EQ(0xFFFDu, lea.value);
+
+        ASSERT_EQ(micro1::InstGroup::GROUP1, result.at(2).operands().group);
+        ASSERT_EQ(1u, result.at(2).operands().rb);
+        ASSERT_EQ(0x1Fu, result.at(2).operands().value);
+        ASSERT_EQ(1u, result.at(3).operands().value);
+        ASSERT_EQ(0x4142u, result.at(4).operands().value);
+        ASSERT_EQ(result.at(5).instruction().at(1).id(), result.at(5).operands().label);
+        ASSERT_EQ(0x1Fu, result.at(6).operands().value);
+        ASSERT_EQ(micro1::toSymbolId(micro1::Keyword::END), result.at(7).operands().opecode);
+        ASSERT_EQ(micro1::InstGroup::INVALID, result.at(7).operands().group);
+    }
+
+    void assertParallelParse(const std::string& program, size_t error_limit = 0) {
+        micro1::SourceBuffer source(program);
+        micro1::ThreadPool pool(4);
+
+        micro1::Diagnostics expected_diagnostics;
+        micro1::Diagnostics result_diagnostics;
+        auto expected = micro1::parse(source, &expected_diagnostics, nullptr, error_limit);
+        auto result = micro1::parse(source, pool, &result_diagnostics, nullptr, error_limit);
+
+        ASSERT_EQ(expected, result);
+        ASSERT_EQ(expected_diagnostics, result_diagnostics);
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_EQ(expected.at(i).addr(), result.at(i).addr()) << i;
+            ASSERT_EQ(expected.at(i).operands().label, result.at(i).operands().label) << i;
+            const auto& expected_tokens = expected.at(i).instruction();
+            const auto& result_tokens = result.at(i).instruction();
+            for (size_t j = 0; j < expected_tokens.size(); j++) {
+                ASSERT_EQ(expected_tokens.at(j).id(), result_tokens.at(j).id()) << i;
+            }
+        }
+    }
+
+    TEST(parseTest, Parallel) {
+        std::string program = "\nTITLE PARALLEL\n";
+        for (int i = 0; program.size() < 1024 * 1024; i++) {
+            program += "L" + std::to_string(i) + ": ADD 1, X\"1F ; comment\n\n    LEA 2, -3(1)\n    DC L" + std::to_string(i / 2) + "\n";
+            if (i % 5000 == 4999)
+                program += "    ORG " + std::to_string(i % 7) + "0\n    DS 3\n";
+            if (i % 3000 == 2999)
+                program += "    ADD 1 2\n    B *-1\n";
+        }
+        program += "END\n";
+
+        assertParallelParse(program);
+    }
+
+    TEST(parseTest, ParallelFallback) {
+        std::string lines;
+        while (lines.size() < 1024 * 1024) {
+            lines += "    NOP\n";
+        }
+
+        // END before the last chunk (rows after END pile up tokens, so they are blank), and TITLE after the first chunk
+        assertParallelParse("TITLE T\n" + lines + "END\n" + std::string(256 * 1024, '\n'));
+        assertParallelParse(std::string(1024 * 1024, '\n') + "TITLE T\n" + lines + "END\n");
+    }
+
+    TEST(parseTest, ErrorLimit) {
+        micro1::SourceBuffer source(std::string("TITLE T\n  ADD 1 2\n  NOP\n  WIO 2\n  FOO\nEND\n"));
+
+        micro1::Diagnostics diagnostics;
+        auto result = micro1::parse(source, &diagnostics, nullptr, 2);
+
+        // parsing stops at the row of the second error
+        ASSERT_EQ(4u, result.size());
+        ASSERT_EQ(2u, diagnostics.size());
+        ASSERT_EQ(3u, diagnostics.back().row);
+
+        // a limit which is not reached changes nothing
+        micro1::Diagnostics all;
+        ASSERT_EQ(micro1::parse(source, &all), micro1::parse(source, &diagnostics, nullptr, 4));
+        ASSERT_EQ(all, diagnostics);
+    }
+
+    TEST(parseTest, ParallelErrorLimit) {
+        std::string errors;
+        while (errors.size() < 1024 * 1024) {
+            errors += "    ADD 1 2\n";
+        }
+        std::string lines;
+        while (lines.size() < 1024 * 1024) {
+            lines += "    NOP\n";
+        }
+
+        for (size_t error_limit : {1, 20, 1000}) {
+            assertParallelParse("TITLE T\n" + errors + "END\n", error_limit);
+            // errors in the last chunks only, and END before them
+            assertParallelParse("TITLE T\n" + lines + errors + "END\n", error_limit);
+            assertParallelParse("TITLE T\n" + lines + "END\n" + errors, error_limit);
+        }
+    }
+
+    void assertDocument(const micro1::Document& document) {
+        micro1::SourceBuffer source(document.text());
+
+        micro1::Diagnostics diagnostics;
+        auto expected = micro1::parse(source, &diagnostics);
+
+        // rows are placed in the document by the offsets of their chunk
+        micro1::Rows result;
+        for (size_t i = 0; i < document.numberOfChunks(); i++) {
+            const auto chunk = document.chunk(i);
+            ASSERT_EQ(result.size(), chunk.first);
+            for (size_t j = 0; j < chunk.rows.size(); j++) {
+                auto row = chunk.rows.at(j);
+                if (j < chunk.relative_rows)
+                    row.addr(static_cast<micro1::M1Addr>(row.addr() + chunk.base));
+                row.renumber(static_cast<int64_t>(chunk.line));
+                result.push_back(row);
+            }
+        }
+
+        ASSERT_EQ(expected.size(), result.size());
+        ASSERT_EQ(expected.size(), document.numberOfRows());
+        ASSERT_TRUE(diagnostics == document.diagnostics());
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_TRUE(expected.at(i) == result.at(i)) << i;
+            ASSERT_EQ(expected.at(i).addr(), result.at(i).addr()) << i;
+            ASSERT_TRUE(document.row(i) == result.at(i)) << i;
+            ASSERT_EQ(document.row(i).addr(), result.at(i).addr()) << i;
+            for (const auto& token : result.at(i).instruction()) {
+                if (token.id() != micro1::NO_SYMBOL) {
+                    ASSERT_EQ(token.str(), document.interner().str(token.id())) << i;
+                }
+            }
+            if (result.at(i).operands().label != micro1::NO_SYMBOL) {
+                ASSERT_EQ(result.at(i).instruction().at(1).str(), document.interner().str(result.at(i).operands().label)) << i;
+            }
+        }
+    }
+
+    TEST(parseTest, Document) {
+        micro1::Document document("TITLE DOC\nL1: ADD 1, X\"1F\n\n    DC L1\n    ST 0, L1\nEND\n");
+        ASSERT_EQ(6, document.size());
+        ASSERT_EQ("    DC L1", document.line(4));
+        assertDocument(document);
+
+        // same number of lines
+        document.edit(2, 1, "L1: LEA 2, -3(1)\n");
+        assertDocument(document);
+        // insertion and removal
+        document.edit(3, 0, "L2: NOP\n    NOP\n    DC 'AB\n");
+        assertDocument(document);
+        document.edit(4, 2, "");
+        assertDocument(document);
+        // ORG moves addresses of the following lines
+        document.edit(2, 0, "    ORG 10");
+        assertDocument(document);
+        document.edit(3, 0, "    DS 3\n");
+        assertDocument(document);
+        document.edit(2, 1, "    ADD 1 2");
+        assertDocument(document);
+        // TITLE changes the state of all lines
+        document.edit(1, 1, "");
+        assertDocument(document);
+        document.edit(1, 0, "\nTITLE DOC\n");
+        assertDocument(document);
+        // lines from END
+        document.edit(document.size() + 1, 0, "    NOP\n\n    DC 1\n");
+        assertDocument(document);
+        document.edit(document.size() - 1, 1, "    HLT");
+        assertDocument(document);
+        document.edit(3, 0, "END\n");
+        assertDocument(document);
+        document.edit(3, 1, "");
+        assertDocument(document);
+        document.edit(document.size() - 3, 1, "");
+        assertDocument(document);
+        document.edit(1, document.size(), "");
+        ASSERT_EQ(0, document.size());
+        assertDocument(document);
+    }
+
+    TEST(parseTest, DocumentMidFileInsertion) {
+        std::string program = "TITLE MIDDLE\n";
+        for (int i = 0; i < 3000; i++) {
+            program += "L" + std::to_string(i) + ": ST 0, L" + std::to_string(i) + "\n";
+        }
+        program += "END\n";
+
+        micro1::Document document(program);
+        assertDocument(document);
+
+        // rows after the inserted lines move to the next row numbers and addresses
+        const auto before = document.row(2000);
+        document.edit(1500, 0, "    NOP\n    DC 'AB\n\n");
+        assertDocument(document);
+        const auto after = document.row(2003);
+        ASSERT_EQ(before.instruction().at(0).str(), after.instruction().at(0).str());
+        ASSERT_EQ(before.instruction().at(0).row() + 3, after.instruction().at(0).row());
+        ASSERT_EQ(before.addr() + 2, after.addr());
+
+        // many lines at once, and their removal
+        std::string lines;
+        for (int i = 0; i < 1000; i++) {
+            lines += "    ST 0, L1\n";
+        }
+        document.edit(1000, 0, lines);
+        assertDocument(document);
+        document.edit(1000, 1000, "");
+        assertDocument(document);
+        // ORG moves all rows after it, and its removal moves them back
+        document.edit(1200, 0, "    ORG X\"1000\n");
+        assertDocument(document);
+        document.edit(1200, 1, "");
+        assertDocument(document);
+        document.edit(1500, 3, "");
+        assertDocument(document);
+        ASSERT_EQ(program, document.text());
+    }
+
+    TEST(parseTest, DocumentChunksOutsideEdit) {
+        std::string program = "TITLE CHUNKS\n";
+        for (int i = 0; i < 20000; i++) {
+            program += "L" + std::to_string(i) + ": ST 0, L" + std::to_string(i) + "\n";
+        }
+        program += "END\n";
+
+        micro1::Document document(program);
+        const size_t chunks = document.numberOfChunks();
+        ASSERT_LT(1, chunks);
+        std::vector<const micro1::Row*> before;
+        std::vector<size_t> lines;
+        for (size_t i = 0; i < chunks; i++) {
+            before.push_back(document.chunk(i).rows.data());
+            lines.push_back(document.chunk(i).line);
+        }
+
+        // the middle of the document
+        document.edit(10001, 0, "    NOP\n    DC 'AB\n\n");
+        assertDocument(document);
+
+        ASSERT_EQ(chunks, document.numberOfChunks());
+        size_t edited = 0;
+        for (size_t i = 0; i < chunks; i++) {
+            const auto chunk = document.chunk(i);
+            if (lines.at(i) <= 10000 && (i + 1 == chunks || 10000 < lines.at(i + 1))) {
+                edited = i;
+                ASSERT_NE(before.at(i), chunk.rows.data());
+                ASSERT_EQ(lines.at(i), chunk.line);
+            } else {
+                // rows of the other chunks are neither copied nor placed again
+                ASSERT_EQ(before.at(i), chunk.rows.data()) << i;
+                ASSERT_EQ(lines.at(i) + (lines.at(i) > 10000 ? 3 : 0), chunk.line) << i;
+            }
+        }
+        ASSERT_LT(0, edited);
+    }
+
+    TEST(parseTest, DocumentRandomEdits) {
+        // no END, because rows after END pile up tokens
+        const std::vector<std::string> lines = {
+            "TITLE RANDOM", "", "; comment", "L0: ADD 1, X\"1F", "L1: LEA 2, -3(1)", "    DC L0", "    DC L2",
+            "    ST 0, L1+1", "    B *-1", "    ORG 20", "    DS 3", "    ADD 1 2", "L2: WIO LPT", "    DC 'AB", "L3:"};
+        std::string program = "TITLE RANDOM\n";
+        for (int i = 0; i < 20000; i++) {
+            program += lines.at(static_cast<size_t>(3 + i % 12)) + "\n";
+        }
+        program += "END\n";
+
+        micro1::Document document(program);
+        assertDocument(document);
+
+        uint32_t seed = 1;
+        const auto random = [&seed](uint64_t n) {
+            seed = seed * 1103515245 + 12345;
+            return (seed >> 16) % n;
+        };
+        for (int i = 0; i < 400; i++) {
+            std::string text;
+            for (uint64_t j = random(3); j > 0; j--) {
+                text += lines.at(random(lines.size())) + "\n";
+            }
+            document.edit(random(document.size() + 1) + 1, random(3), text);
+            if (i % 50 == 49)
+                assertDocument(document);
+        }
+        assertDocument(document);
+    }
+
 }
@@ -0,0 +1,107 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file test_scanner.cc
+ * @brief Test for scanner.cc
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/scanner.h"
+
+#include "micro1-as/charclass.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+    size_t skipped(const char* (*skip)(const char*, const char*), const std::string& str) {
+        return static_cast<size_t>(skip(str.data(), str.data() + str.size()) - str.data());
+    }
+
+    TEST(scannerTest, skipBlanks) {
+        ASSERT_EQ(0u,  skipped(micro1::skipBlanks, ""));
+        ASSERT_EQ(0u,  skipped(micro1::skipBlanks, "ADD"));
+        ASSERT_EQ(4u,  skipped(micro1::skipBlanks, " \t\r\fADD"));
+        ASSERT_EQ(2u,  skipped(micro1::skipBlanks, "  \n  "));
+        ASSERT_EQ(5u,  skipped(micro1::skipBlanks, "     "));
+        ASSERT_EQ(40u, skipped(micro1::skipBlanks, std::string(40, ' ') + ";"));
+        ASSERT_EQ(37u, skipped(micro1::skipBlanks, std::string(37, '\t') + "\n" + std::string(20, ' ')));
+        ASSERT_EQ(17u, skipped(micro1::skipBlanks, std::string(17, ' ') + "\xA0" + std::string(20, ' ')));
+    }
+
+    TEST(scannerTest, skipAlnums) {
+        ASSERT_EQ(0u,  skipped(micro1::skipAlnums, ""));
+        ASSERT_EQ(3u,  skipped(micro1::skipAlnums, "ADD 1, 2"));
+        ASSERT_EQ(6u,  skipped(micro1::skipAlnums, "azAZ09:"));
+        ASSERT_EQ(0u,  skipped(micro1::skipAlnums, "@[`{/:"));
+        ASSERT_EQ(33u, skipped(micro1::skipAlnums, std::string(33, 'Q') + "\n"));
+        ASSERT_EQ(16u, skipped(micro1::skipAlnums, std::string(16, 'z') + "\x80" + std::string(16, 'z')));
+        ASSERT_EQ(50u, skipped(micro1::skipAlnums, std::string(25, 'a') + std::string(25, '7')));
+    }
+
+    TEST(scannerTest, skipXDigits) {
+        ASSERT_EQ(0u,  skipped(micro1::skipXDigits, ""));
+        ASSERT_EQ(4u,  skipped(micro1::skipXDigits, "B3DF (1)"));
+        ASSERT_EQ(12u, skipped(micro1::skipXDigits, "09afAF09afAFG"));
+        ASSERT_EQ(0u,  skipped(micro1::skipXDigits, "gG@`/:"));
+        ASSERT_EQ(31u, skipped(micro1::skipXDigits, std::string(31, 'f') + "g" + std::string(16, 'f')));
+    }
+
+    TEST(scannerTest, findEOL) {
+        ASSERT_EQ(0u,  skipped(micro1::findEOL, ""));
+        ASSERT_EQ(3u,  skipped(micro1::findEOL, "ADD"));
+        ASSERT_EQ(3u,  skipped(micro1::findEOL, "ADD\nSUB\n"));
+        ASSERT_EQ(0u,  skipped(micro1::findEOL, "\n"));
+        ASSERT_EQ(70u, skipped(micro1::findEOL, std::string(70, ';') + "\n"));
+    }
+
+    TEST(charClassTest, CHAR_TABLE) {
+        static_assert(micro1::charClass('A') == micro1::CharClass::ALPHA, "");
+        static_assert(micro1::charClass('7') == micro1::CharClass::DIGIT, "");
+
+        for (int i = 0; i < 256; i++) {
+            const char c = static_cast<char>(i);
+            const bool digit = '0' <= i && i <= '9';
+            const bool alpha = ('A' <= i && i <= 'Z') || ('a' <= i && i <= 'z');
+            const bool xdigit = digit || ('A' <= i && i <= 'F') || ('a' <= i && i <= 'f');
+
+            ASSERT_EQ(digit, micro1::hasCharFlag(c, micro1::CHAR_DIGIT)) << i;
+            ASSERT_EQ(digit || alpha, micro1::hasCharFlag(c, micro1::CHAR_ALNUM)) << i;
+            ASSERT_EQ(xdigit, micro1::hasCharFlag(c, micro1::CHAR_XDIGIT)) << i;
+            ASSERT_EQ('0' <= i && i <= '7', micro1::hasCharFlag(c, micro1::CHAR_OCTAL)) << i;
+            ASSERT_EQ(i == '0' || i == '1', micro1::hasCharFlag(c, micro1::CHAR_BINARY)) << i;
+            if (i >= 0x80) {
+                ASSERT_EQ(micro1::CharClass::OTHER, micro1::charClass(c)) << i;
+            }
+        }
+
+        ASSERT_EQ(micro1::CharClass::BLANK,     micro1::charClass('\t'));
+        ASSERT_EQ(micro1::CharClass::NEWLINE,   micro1::charClass('\n'));
+        ASSERT_EQ(micro1::CharClass::SEMICOLON, micro1::charClass(';'));
+        ASSERT_EQ(micro1::CharClass::SIGN,      micro1::charClass('-'));
+        ASSERT_EQ(micro1::CharClass::QUOTE,     micro1::charClass('\''));
+        ASSERT_EQ(micro1::CharClass::OTHER,     micro1::charClass('_'));
+    }
+
+}
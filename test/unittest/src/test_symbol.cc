@@ -0,0 +1,103 @@
+// Copyright (c) 2020 Kenta Arai
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file test_symbol.cc
+ * @brief Test for symbol.cc
+ * @author Kenta Arai
+ * @date 2026/10/17
+ */
+
+#include "micro1-as/symbol.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace {
+
+    TEST(symbolTest, InsertAndFind) {
+        micro1::SymbolTable symbol_table;
+        ASSERT_TRUE(symbol_table.empty());
+        ASSERT_EQ(nullptr, symbol_table.find("L"));
+
+        ASSERT_TRUE(symbol_table.insert("L", 1).second);
+        ASSERT_TRUE(symbol_table.insert("M", 2).second);
+        // the first address of a label is kept
+        ASSERT_FALSE(symbol_table.insert("L", 3).second);
+
+        ASSERT_EQ(2u, symbol_table.size());
+        ASSERT_EQ(1, symbol_table.find("L")->addr);
+        ASSERT_EQ(2, symbol_table.find("M")->addr);
+        ASSERT_EQ(nullptr, symbol_table.find("N"));
+
+        symbol_table.clear();
+        ASSERT_TRUE(symbol_table.empty());
+        ASSERT_EQ(nullptr, symbol_table.find("L"));
+    }
+
+    TEST(symbolTest, ManyLabels) {
+        std::deque<std::string> labels;
+        micro1::SymbolTable symbol_table;
+        for (size_t i = 0; i < 100000; i++) {
+            labels.push_back("L" + std::to_string(i));
+            ASSERT_TRUE(symbol_table.insert(labels.back(), static_cast<micro1::M1Addr>(i), i).second);
+        }
+
+        ASSERT_EQ(labels.size(), symbol_table.size());
+        for (size_t i = 0; i < labels.size(); i++) {
+            const auto symbol = symbol_table.find("L" + std::to_string(i));
+            ASSERT_NE(nullptr, symbol);
+            ASSERT_EQ(static_cast<micro1::M1Addr>(i), symbol->addr);
+        }
+        ASSERT_EQ(nullptr, symbol_table.find("L100000"));
+    }
+
+    TEST(symbolTest, Sorted) {
+        micro1::SymbolTable symbol_table;
+        symbol_table.insert("LOOP", 3);
+        symbol_table.insert("A", 5);
+        symbol_table.insert("L", 1);
+        symbol_table.insert("Z9", 0);
+
+        std::vector<micro1::Symbol> expected = {{"A", 5}, {"L", 1}, {"LOOP", 3}, {"Z9", 0}};
+        ASSERT_EQ(expected, symbol_table.sorted());
+    }
+
+    TEST(symbolTest, CrossReference) {
+        micro1::CrossReference cross_reference;
+        ASSERT_TRUE(cross_reference.references(0).empty());
+
+        cross_reference.assign(3, {{2, 1}, {0, 3}, {2, 4}, {2, 4}, {0, 7}});
+        ASSERT_EQ(3u, cross_reference.size());
+
+        auto references = cross_reference.references(0);
+        ASSERT_EQ((std::vector<size_t>{3, 7}), std::vector<size_t>(references.begin(), references.end()));
+        ASSERT_TRUE(cross_reference.references(1).empty());
+        references = cross_reference.references(2);
+        ASSERT_EQ((std::vector<size_t>{1, 4, 4}), std::vector<size_t>(references.begin(), references.end()));
+        ASSERT_TRUE(cross_reference.references(3).empty());
+    }
+
+}  // namespace